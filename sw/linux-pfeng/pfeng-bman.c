@@ -6,15 +6,25 @@
  */
 
 #include <linux/prefetch.h>
+#include <linux/seq_file.h>
+#include <linux/version.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6,6,0)
+#include <net/page_pool/helpers.h>
+#else
+#include <net/page_pool.h>
+#endif
 
 #include "pfe_cfg.h"
 #include "pfeng.h"
 
-#define PFE_RXB_TRUESIZE	2048 /* PAGE_SIZE >> 1 */
-#define PFE_RXB_PAD		NET_SKB_PAD /* add extra space if needed */
-#define PFE_RXB_DMA_SIZE	(SKB_WITH_OVERHEAD(PFE_RXB_TRUESIZE) - PFE_RXB_PAD)
+#define PFE_RXB_DMA_DIR		DMA_BIDIRECTIONAL /* XDP_TX sends from RX buffer */
+
+/* RX ring is refilled once per poll, in batches of up to this size */
+#define PFENG_BMAN_REFILL_BATCH	64U
+#define PFENG_BMAN_REFILL_THR_MIN	8U
 
-#define PFENG_BMAN_REFILL_THR	32
+/* Received buffers are taken from the RX ring in bursts of up to this size */
+#define PFENG_BMAN_RX_BURST	16U
 
 /* sanity check: we need RX buffering internal support disabled */
 #if (TRUE == PFE_HIF_CHNL_CFG_RX_BUFFERS_ENABLED)
@@ -24,21 +34,35 @@
 struct pfeng_rx_map {
 	dma_addr_t dma;
 	struct page *page;
-	u16 page_offset;
+#ifdef PFENG_CFG_XSK_SUPPORT
+	struct xdp_buff *xsk;
+#endif /* PFENG_CFG_XSK_SUPPORT */
 };
 
 struct pfeng_rx_chnl_pool {
 	pfe_hif_chnl_t	*chnl;
 	struct device	*dev;
+	struct page_pool		*page_pool;
 	u32				id;
 	u32				depth;
 
 	/* mappings of hif_drv rx ring */
 	struct pfeng_rx_map 		*rx_tbl;
+	u32				tbl_size;
 	u32				rd_idx;
 	u32				wr_idx;
-	u32				alloc_idx;
 	u32				idx_mask;
+	/* free ring slots triggering the refill, follows the ring depth */
+	u32				refill_thr;
+	/* received buffers dequeued from the ring, not yet pulled */
+	pfe_hif_ring_buf_t		burst[PFENG_BMAN_RX_BURST];
+	u32				burst_idx;
+	u32				burst_cnt;
+
+	/* stats */
+	u64				alloc_err;
+	u64				refills;
+	u64				refill_starved;
 };
 
 struct pfeng_tx_map {
@@ -48,6 +72,9 @@ struct pfeng_tx_map {
 	u32				size;
 	bool				pages;
 	struct sk_buff			*skb;
+	struct xdp_frame		*xdpf;
+	/* sender of copied frame, the skb is gone already */
+	struct net_device		*netdev;
 	u8				flags;
 };
 
@@ -56,15 +83,27 @@ struct pfeng_tx_chnl_pool {
 
 	/* mappings for hif_drv tx ring */
 	struct pfeng_tx_map		*tx_tbl;
+	u32				tbl_size;
 	u32				rd_idx;
 	u32				wr_idx;
 	u32				idx_mask;
+
+	/* bounce buffers for copied frames and TX headers, one per ring entry, mapped for the pool life */
+	void				*cb_va;
+	dma_addr_t			cb_dma;
 };
 
+/* Refill when a quarter of the ring is free, big rings still refill in single batch */
+static void pfeng_bman_set_refill_thr(struct pfeng_rx_chnl_pool *pool)
+{
+	pool->refill_thr = clamp_t(u32, pool->depth / 4, PFENG_BMAN_REFILL_THR_MIN, PFENG_BMAN_REFILL_BATCH);
+}
+
 int pfeng_bman_pool_create(struct pfeng_hif_chnl *chnl)
 {
 	struct pfeng_rx_chnl_pool *rx_pool;
 	struct pfeng_tx_chnl_pool *tx_pool;
+	struct page_pool_params pp_params = { 0 };
 
 	/* RX pool */
 	rx_pool = kzalloc(sizeof(*rx_pool), GFP_KERNEL);
@@ -83,19 +122,37 @@ int pfeng_bman_pool_create(struct pfeng_hif_chnl *chnl)
 		dev_err(chnl->dev, "chnl%d: failed. No mem\n", rx_pool->id);
 		goto err;
 	}
+	rx_pool->tbl_size = rx_pool->depth;
 	rx_pool->rd_idx = 0;
 	rx_pool->wr_idx = 0;
-	rx_pool->alloc_idx = 0;
 	rx_pool->idx_mask = pfe_hif_chnl_get_rx_fifo_depth(chnl->priv) - 1;
+	pfeng_bman_set_refill_thr(rx_pool);
 
 	chnl->bman.rx_pool = rx_pool;
 
+	/* Pages stay DMA mapped for the whole life of the pool */
+	pp_params.order = 0;
+	pp_params.flags = PP_FLAG_DMA_MAP;
+	pp_params.pool_size = rx_pool->depth;
+	pp_params.nid = dev_to_node(chnl->dev);
+	pp_params.dev = chnl->dev;
+	pp_params.dma_dir = PFE_RXB_DMA_DIR;
+
+	rx_pool->page_pool = page_pool_create(&pp_params);
+	if (IS_ERR(rx_pool->page_pool)) {
+		dev_err(chnl->dev, "chnl%d: page_pool create failed: %ld\n", rx_pool->id, PTR_ERR(rx_pool->page_pool));
+		rx_pool->page_pool = NULL;
+		goto err;
+	}
+
 	/* TX pool */
 	tx_pool = kzalloc(sizeof(*tx_pool), GFP_KERNEL);
-	if (!rx_pool) {
+	if (!tx_pool) {
 		dev_err(chnl->dev, "chnl%d: No mem for bman tx_pool\n", pfe_hif_chnl_get_id(chnl->priv));
 		goto err;
 	}
+	/* Released by pfeng_bman_pool_destroy() on failure */
+	chnl->bman.tx_pool = tx_pool;
 
 	tx_pool->depth = pfe_hif_chnl_get_tx_fifo_depth(chnl->priv);
 	tx_pool->tx_tbl = kzalloc(sizeof(struct pfeng_tx_map) * tx_pool->depth, GFP_KERNEL);
@@ -103,12 +160,19 @@ int pfeng_bman_pool_create(struct pfeng_hif_chnl *chnl)
 		dev_err(chnl->dev, "chnl%d: failed. No mem\n", rx_pool->id);
 		goto err;
 	}
+	tx_pool->tbl_size = tx_pool->depth;
+
+	tx_pool->cb_va = dma_alloc_coherent(chnl->dev, tx_pool->tbl_size * PFENG_TX_COPYBREAK_BUF,
+					    &tx_pool->cb_dma, GFP_KERNEL);
+	if (!tx_pool->cb_va) {
+		dev_err(chnl->dev, "chnl%d: No mem for TX bounce buffers\n", rx_pool->id);
+		goto err;
+	}
+
 	tx_pool->rd_idx = 0;
 	tx_pool->wr_idx = 0;
 	tx_pool->idx_mask = pfe_hif_chnl_get_tx_fifo_depth(chnl->priv) - 1;
 
-	chnl->bman.tx_pool = tx_pool;
-
 	return 0;
 
 err:
@@ -120,13 +184,24 @@ void pfeng_bman_pool_destroy(struct pfeng_hif_chnl *chnl)
 {
 	struct pfeng_rx_chnl_pool *rx_pool = (struct pfeng_rx_chnl_pool *)chnl->bman.rx_pool;
 	struct pfeng_tx_chnl_pool *tx_pool = (struct pfeng_tx_chnl_pool *)chnl->bman.tx_pool;
+	u32 i;
 
 	if (rx_pool) {
 		if(rx_pool->rx_tbl) {
+			/* Return pages still owned by the ring */
+			for (i = 0; i < rx_pool->tbl_size; i++) {
+				if (rx_pool->rx_tbl[i].page)
+					page_pool_put_full_page(rx_pool->page_pool, rx_pool->rx_tbl[i].page, false);
+			}
 			kfree(rx_pool->rx_tbl);
 			rx_pool->rx_tbl = NULL;
 		}
 
+		if (rx_pool->page_pool) {
+			page_pool_destroy(rx_pool->page_pool);
+			rx_pool->page_pool = NULL;
+		}
+
 		kfree(rx_pool);
 		chnl->bman.rx_pool = NULL;
 	}
@@ -137,6 +212,12 @@ void pfeng_bman_pool_destroy(struct pfeng_hif_chnl *chnl)
 			tx_pool->tx_tbl = NULL;
 		}
 
+		if (tx_pool->cb_va) {
+			dma_free_coherent(chnl->dev, tx_pool->tbl_size * PFENG_TX_COPYBREAK_BUF,
+					  tx_pool->cb_va, tx_pool->cb_dma);
+			tx_pool->cb_va = NULL;
+		}
+
 		kfree(tx_pool);
 		chnl->bman.tx_pool = NULL;
 	}
@@ -144,6 +225,77 @@ void pfeng_bman_pool_destroy(struct pfeng_hif_chnl *chnl)
 	return;
 }
 
+/**
+ * @brief	Adapt RX/TX mapping tables to new HIF ring depths
+ * @details	Tables only grow, so returning to the previous depths can not fail.
+ *		RX buffers have to be released by pfeng_bman_rx_release_all() and
+ *		all TX frames confirmed before.
+ * @param[in]	chnl The HIF channel
+ * @param[in]	rx_depth New RX ring depth, power of 2
+ * @param[in]	tx_depth New TX ring depth, power of 2
+ * @return	0 if OK, -ENOMEM with the pools unchanged otherwise
+ */
+int pfeng_bman_pool_resize(struct pfeng_hif_chnl *chnl, u32 rx_depth, u32 tx_depth)
+{
+	struct pfeng_rx_chnl_pool *rx_pool = chnl->bman.rx_pool;
+	struct pfeng_tx_chnl_pool *tx_pool = chnl->bman.tx_pool;
+	struct pfeng_rx_map *rx_tbl = NULL;
+	struct pfeng_tx_map *tx_tbl = NULL;
+	dma_addr_t cb_dma = 0;
+	void *cb_va = NULL;
+
+	if (rx_depth > rx_pool->tbl_size) {
+		rx_tbl = kcalloc(rx_depth, sizeof(*rx_tbl), GFP_KERNEL);
+		if (!rx_tbl)
+			return -ENOMEM;
+	}
+
+	if (tx_depth > tx_pool->tbl_size) {
+		tx_tbl = kcalloc(tx_depth, sizeof(*tx_tbl), GFP_KERNEL);
+		if (!tx_tbl) {
+			kfree(rx_tbl);
+			return -ENOMEM;
+		}
+
+		cb_va = dma_alloc_coherent(chnl->dev, tx_depth * PFENG_TX_COPYBREAK_BUF, &cb_dma, GFP_KERNEL);
+		if (!cb_va) {
+			kfree(tx_tbl);
+			kfree(rx_tbl);
+			return -ENOMEM;
+		}
+	}
+
+	if (rx_tbl) {
+		kfree(rx_pool->rx_tbl);
+		rx_pool->rx_tbl = rx_tbl;
+		rx_pool->tbl_size = rx_depth;
+	}
+	rx_pool->depth = rx_depth;
+	rx_pool->idx_mask = rx_depth - 1;
+	pfeng_bman_set_refill_thr(rx_pool);
+	rx_pool->rd_idx = 0;
+	rx_pool->wr_idx = 0;
+	rx_pool->burst_idx = 0;
+	rx_pool->burst_cnt = 0;
+
+	if (tx_tbl) {
+		kfree(tx_pool->tx_tbl);
+		tx_pool->tx_tbl = tx_tbl;
+		dma_free_coherent(chnl->dev, tx_pool->tbl_size * PFENG_TX_COPYBREAK_BUF,
+				  tx_pool->cb_va, tx_pool->cb_dma);
+		tx_pool->cb_va = cb_va;
+		tx_pool->cb_dma = cb_dma;
+		tx_pool->tbl_size = tx_depth;
+	}
+	memset(tx_pool->tx_tbl, 0, sizeof(*tx_pool->tx_tbl) * tx_pool->tbl_size);
+	tx_pool->depth = tx_depth;
+	tx_pool->idx_mask = tx_depth - 1;
+	tx_pool->rd_idx = 0;
+	tx_pool->wr_idx = 0;
+
+	return 0;
+}
+
 bool pfeng_hif_chnl_txconf_check(struct pfeng_hif_chnl *chnl, u32 elems)
 {
 	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
@@ -166,15 +318,117 @@ int pfeng_hif_chnl_txconf_put_map_frag(struct pfeng_hif_chnl *chnl, void *va_add
 	pool->tx_tbl[idx].pa_addr = pa_addr;
 	pool->tx_tbl[idx].size = size;
 	pool->tx_tbl[idx].skb = skb;
-#ifdef PFE_CFG_MULTI_INSTANCE_SUPPORT
+	pool->tx_tbl[idx].xdpf = NULL;
 	pool->tx_tbl[idx].flags = flags;
-#endif
 
 	pool->wr_idx = (pool->wr_idx + 1) & pool->idx_mask;
 
 	return idx;
 }
 
+/**
+ * @brief	Get bounce buffer of the next TX ring entry
+ * @details	Buffer is PFENG_TX_COPYBREAK_BUF long and stays valid until the
+ *		entry is confirmed. Caller has to hold the channel TX lock.
+ * @param[in]	chnl The HIF channel
+ * @param[out]	des DMA address of the buffer
+ * @return	The buffer VA
+ */
+void *pfeng_hif_chnl_txconf_copybreak_buf(struct pfeng_hif_chnl *chnl, dma_addr_t *des)
+{
+	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
+	u32 offs = pool->wr_idx * PFENG_TX_COPYBREAK_BUF;
+
+	*des = pool->cb_dma + offs;
+
+	return pool->cb_va + offs;
+}
+
+int pfeng_hif_chnl_txconf_put_map_copy(struct pfeng_hif_chnl *chnl, void *va_addr, addr_t pa_addr, u32 size, struct net_device *netdev)
+{
+	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
+	u32 idx = pool->wr_idx;
+
+	pool->tx_tbl[idx].va_addr = va_addr;
+	pool->tx_tbl[idx].pa_addr = pa_addr;
+	pool->tx_tbl[idx].size = size;
+	pool->tx_tbl[idx].skb = NULL;
+	pool->tx_tbl[idx].xdpf = NULL;
+	pool->tx_tbl[idx].netdev = netdev;
+	pool->tx_tbl[idx].flags = PFENG_MAP_PKT_COPYBREAK;
+
+	pool->wr_idx = (pool->wr_idx + 1) & pool->idx_mask;
+
+	return idx;
+}
+
+void pfeng_hif_chnl_txconf_unroll_map_copy(struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
+	u32 idx = (pool->wr_idx - 1) & pool->idx_mask;
+
+	pool->tx_tbl[idx].size = 0;
+	pool->wr_idx = idx;
+}
+
+int pfeng_hif_chnl_txconf_put_map_xdp(struct pfeng_hif_chnl *chnl, void *va_addr, addr_t pa_addr, u32 size, struct xdp_frame *xdpf, u8 flags)
+{
+	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
+	u32 idx = pool->wr_idx;
+
+	pool->tx_tbl[idx].va_addr = va_addr;
+	pool->tx_tbl[idx].pa_addr = pa_addr;
+	pool->tx_tbl[idx].size = size;
+	pool->tx_tbl[idx].skb = NULL;
+	pool->tx_tbl[idx].xdpf = xdpf;
+	pool->tx_tbl[idx].flags = flags;
+
+	pool->wr_idx = (pool->wr_idx + 1) & pool->idx_mask;
+
+	return idx;
+}
+
+void pfeng_hif_chnl_txconf_unroll_map_xdp(struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
+	u32 idx = (pool->wr_idx - 1) & pool->idx_mask;
+
+	/* XDP_TX buffers belong to page_pool and are not mapped here */
+	if (pool->tx_tbl[idx].flags == PFENG_MAP_PKT_XDP_FRAME)
+		dma_unmap_single(chnl->dev, pool->tx_tbl[idx].pa_addr, pool->tx_tbl[idx].size, DMA_TO_DEVICE);
+	pool->tx_tbl[idx].size = 0;
+
+	pool->wr_idx = idx;
+}
+
+static int pfeng_hif_chnl_txconf_free_map_xdp(struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
+	u32 idx = pool->rd_idx;
+
+	if (pool->tx_tbl[idx].flags == PFENG_MAP_PKT_XSK_TX) {
+		/* TX header slot followed by UMEM frame, both stay mapped */
+		pool->tx_tbl[idx].size = 0;
+		idx = (idx + 1) & pool->idx_mask;
+		pool->tx_tbl[idx].size = 0;
+
+		pool->rd_idx = (idx + 1) & pool->idx_mask;
+
+		return 0;
+	}
+
+	if (pool->tx_tbl[idx].flags == PFENG_MAP_PKT_XDP_FRAME)
+		dma_unmap_single(chnl->dev, pool->tx_tbl[idx].pa_addr, pool->tx_tbl[idx].size, DMA_TO_DEVICE);
+	pool->tx_tbl[idx].size = 0;
+
+	xdp_return_frame(pool->tx_tbl[idx].xdpf);
+	pool->tx_tbl[idx].xdpf = NULL;
+
+	pool->rd_idx = (idx + 1) & pool->idx_mask;
+
+	return 0;
+}
+
 u8 pfeng_hif_chnl_txconf_get_flag(struct pfeng_hif_chnl *chnl)
 {
 	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
@@ -191,6 +445,29 @@ struct sk_buff *pfeng_hif_chnl_txconf_get_skbuf(struct pfeng_hif_chnl *chnl)
 	return pool->tx_tbl[idx].skb;
 }
 
+/**
+ * @brief	Get sender of the frame to be confirmed
+ * @param[in]	chnl The HIF channel
+ * @param[out]	len Length of the frame reported to BQL
+ * @return	The net device or NULL for frames not accounted by BQL
+ */
+struct net_device *pfeng_hif_chnl_txconf_get_netdev(struct pfeng_hif_chnl *chnl, u32 *len)
+{
+	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
+	struct pfeng_tx_map *map = &pool->tx_tbl[pool->rd_idx];
+
+	if (map->flags == PFENG_MAP_PKT_COPYBREAK) {
+		*len = map->size;
+		return map->netdev;
+	}
+
+	if (!map->skb)
+		return NULL;
+
+	*len = map->skb->len;
+	return map->skb->dev;
+}
+
 int pfeng_hif_chnl_txconf_free_map_full(struct pfeng_hif_chnl *chnl)
 {
 	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
@@ -198,10 +475,27 @@ int pfeng_hif_chnl_txconf_free_map_full(struct pfeng_hif_chnl *chnl)
 	struct sk_buff *skb = pool->tx_tbl[idx].skb;
 	u32 nfrags;
 
+	/* Copied frame, the bounce buffer stays mapped */
+	if (pool->tx_tbl[idx].flags == PFENG_MAP_PKT_COPYBREAK) {
+		pool->tx_tbl[idx].size = 0;
+		pool->rd_idx = (idx + 1) & pool->idx_mask;
+		return 0;
+	}
+
+	/* XDP and AF_XDP frames */
+	if (unlikely(pool->tx_tbl[idx].flags >= PFENG_MAP_PKT_XDP_TX))
+		return pfeng_hif_chnl_txconf_free_map_xdp(chnl);
+
 	BUG_ON(!skb);
 
 	nfrags = skb_shinfo(skb)->nr_frags;
 
+	/* TX header sent from bounce buffer in front of the frame */
+	if (unlikely(pool->tx_tbl[idx].flags == PFENG_MAP_PKT_TX_HDR)) {
+		pool->tx_tbl[idx].size = 0;
+		idx = (idx + 1) & pool->idx_mask;
+	}
+
 	/* Unmap linear part */
 	dma_unmap_single_attrs(chnl->dev, pool->tx_tbl[idx].pa_addr, pool->tx_tbl[idx].size, DMA_TO_DEVICE, 0);
 	pool->tx_tbl[idx].size = 0;
@@ -225,6 +519,7 @@ int pfeng_hif_chnl_txconf_unroll_map_full(struct pfeng_hif_chnl *chnl, u32 idx,
 {
 	struct pfeng_tx_chnl_pool *pool = chnl->bman.tx_pool;
 	struct sk_buff *skb = pool->tx_tbl[idx].skb;
+	u32 first = idx;
 
 	BUG_ON(!skb);
 
@@ -241,11 +536,18 @@ int pfeng_hif_chnl_txconf_unroll_map_full(struct pfeng_hif_chnl *chnl, u32 idx,
 	dma_unmap_single_attrs(chnl->dev, pool->tx_tbl[idx].pa_addr, pool->tx_tbl[idx].size, DMA_TO_DEVICE, 0);
 	pool->tx_tbl[idx].size = 0;
 
+	/* TX header BD in front of the linear part is not mapped */
+	if (unlikely(idx != first)) {
+		pool->tx_tbl[first].size = 0;
+		idx = first;
+	}
+
 	pool->wr_idx = idx;
 
 	return 0;
 }
 
+
 static inline int pfeng_bman_rx_chnl_pool_unused(struct pfeng_rx_chnl_pool *pool)
 {
 	return pool->depth - pool->wr_idx + pool->rd_idx - 1;
@@ -259,173 +561,481 @@ static inline struct pfeng_rx_map *pfeng_bman_get_rx_map(struct pfeng_rx_chnl_po
 static bool pfeng_bman_buf_alloc_and_map(struct pfeng_rx_chnl_pool *pool, struct pfeng_rx_map *rx_map)
 {
 	struct page *page;
-	dma_addr_t dma;
-
-	/* Request page from DMA safe region */
-	page = __dev_alloc_page(GFP_DMA32 | GFP_ATOMIC | __GFP_NOWARN);
-	if (unlikely(!page))
-		return false;
 
-	/* do dma map */
-	dma = dma_map_page(pool->dev, page, 0, PAGE_SIZE, DMA_FROM_DEVICE);
-	if (unlikely(dma_mapping_error(pool->dev, dma))) {
-		__free_page(page);
+	/* Request page from DMA safe region. Page is already mapped by page_pool */
+	page = page_pool_alloc_pages(pool->page_pool, GFP_DMA32 | GFP_ATOMIC | __GFP_NOWARN);
+	if (unlikely(!page)) {
+		pool->alloc_err++;
 		return false;
 	}
 
-	rx_map->dma = dma;
+	rx_map->dma = page_pool_get_dma_addr(page);
 	rx_map->page = page;
-	rx_map->page_offset = PFE_RXB_PAD;
+
+	/* Recycled page may be dirty, hand it over to device */
+	dma_sync_single_range_for_device(pool->dev, rx_map->dma, PFE_RXB_PAD,
+					 PFE_RXB_DMA_SIZE, PFE_RXB_DMA_DIR);
 
 	return true;
 }
 
-static int pfeng_hif_chnl_refill_rx_buffer(struct pfeng_hif_chnl *chnl, struct pfeng_rx_map *rx_map)
+#ifdef PFENG_CFG_XSK_SUPPORT
+static dma_addr_t pfeng_hif_chnl_refill_xsk_buffer(struct pfeng_hif_chnl *chnl, struct pfeng_rx_map *rx_map)
 {
 	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
-	int err;
 
-	/*	Ask for new buffer */
-	if (unlikely(!rx_map->page))
-		if (unlikely(!pfeng_bman_buf_alloc_and_map(pool, rx_map))) {
-			dev_err(chnl->dev, "buffer allocation error\n");
-			return -ENOMEM;
+	/* Take buffer from XSK fill ring, running out is not an error */
+	if (!rx_map->xsk) {
+		rx_map->xsk = xsk_buff_alloc(chnl->xsk_pool);
+		if (unlikely(!rx_map->xsk)) {
+			pool->alloc_err++;
+			return 0;
 		}
+	}
 
-	/* Add new buffer to ring */
-	err = pfe_hif_chnl_supply_rx_buf(chnl->priv, (void *)(rx_map->dma + rx_map->page_offset), PFE_RXB_DMA_SIZE);
-	if (unlikely(err))
-		return err;
+	return xsk_buff_xdp_get_dma(rx_map->xsk);
+}
+#endif /* PFENG_CFG_XSK_SUPPORT */
 
-	return 0;
+/*
+ * RX ring is dequeued and refilled without lock (PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER),
+ * which holds while the caller owns the RX NAPI: it runs the poll, or NAPI
+ * is disabled or not added yet.
+ */
+static inline void pfeng_bman_rx_owner_check(struct pfeng_hif_chnl *chnl)
+{
+#ifdef PFE_CFG_DEBUG
+	WARN_ON_ONCE(chnl->napi.poll && !test_bit(NAPI_STATE_SCHED, &chnl->napi.state));
+#endif /* PFE_CFG_DEBUG */
 }
 
-static int pfeng_hif_chnl_refill_rx_pool(struct pfeng_hif_chnl *chnl, int count)
+/* Get DMA address of the buffer for the ring slot, the buffer stays in slot if not supplied */
+static dma_addr_t pfeng_hif_chnl_refill_rx_buffer(struct pfeng_hif_chnl *chnl, struct pfeng_rx_map *rx_map)
 {
 	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
-	struct pfeng_rx_map *rx_map;
-	int i, ret = 0;
 
-	for (i = 0; i < count; i++) {
-		rx_map = pfeng_bman_get_rx_map(pool, pool->wr_idx);
-		ret = pfeng_hif_chnl_refill_rx_buffer(chnl, rx_map);
-		if (unlikely(ret))
-			break;
-		/* push rx map */
-		pool->wr_idx++;
-	}
+#ifdef PFENG_CFG_XSK_SUPPORT
+	if (chnl->xsk_pool)
+		return pfeng_hif_chnl_refill_xsk_buffer(chnl, rx_map);
+#endif /* PFENG_CFG_XSK_SUPPORT */
 
-	pool->alloc_idx = pool->wr_idx;
+	/* Ask for new buffer. Empty page_pool cache is refilled by bulk page allocation */
+	if (unlikely(!rx_map->page))
+		if (unlikely(!pfeng_bman_buf_alloc_and_map(pool, rx_map)))
+			return 0;
 
-	return ret;
+	return rx_map->dma + PFE_RXB_PAD;
 }
 
-static bool pfeng_page_reusable(struct page *page)
+/*
+ * Supply up to count buffers in batches, one ring update per batch. The RX
+ * ring is not locked, refill and receive run from the channel RX NAPI only.
+ */
+static int pfeng_hif_chnl_refill_rx_pool(struct pfeng_hif_chnl *chnl, int count)
 {
-	return (!page_is_pfmemalloc(page) && page_ref_count(page) == 1);
-}
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
+	void *bufs[PFENG_BMAN_REFILL_BATCH];
+	u32 size = PFE_RXB_DMA_SIZE;
+	u32 i, n, supplied;
+	dma_addr_t dma;
+	int done = 0;
+
+#ifdef PFENG_CFG_XSK_SUPPORT
+	if (chnl->xsk_pool)
+		size = xsk_pool_get_rx_frame_size(chnl->xsk_pool);
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
+	if (!count)
+		return 0;
+
+	pfeng_bman_rx_owner_check(chnl);
+	pool->refills++;
+
+	while (done < count) {
+		n = min_t(u32, count - done, PFENG_BMAN_REFILL_BATCH);
+		for (i = 0; i < n; i++) {
+			dma = pfeng_hif_chnl_refill_rx_buffer(chnl, pfeng_bman_get_rx_map(pool, pool->wr_idx + i));
+			if (unlikely(!dma))
+				break;
+			bufs[i] = (void *)dma;
+		}
 
-static void pfeng_reuse_page(struct pfeng_rx_chnl_pool *pool,
-			     struct pfeng_rx_map *old)
-{
-	struct pfeng_rx_map *new;
+		supplied = i ? pfe_hif_chnl_supply_rx_bufs(chnl->priv, (const void *const *)bufs, size, i) : 0;
+		/* push rx maps */
+		pool->wr_idx += supplied;
+		done += supplied;
 
-	/* next buf mapping that may reuse a page */
-	new = pfeng_bman_get_rx_map(pool, pool->alloc_idx);
+		if (unlikely(supplied < n)) {
+			/* Out of buffers, the ring is left short */
+			if (i < n)
+				pool->refill_starved++;
+			break;
+		}
+	}
 
-	/* copy page reference */
-	*new = *old;
+	return done;
+}
 
-	/* advance page allocation idx */
-	pool->alloc_idx++;
+/* Let the stack return the page to page_pool once the skb is freed */
+static inline void pfeng_bman_skb_mark_for_recycle(struct pfeng_rx_chnl_pool *pool, struct sk_buff *skb, struct page *page)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,15,0)
+	skb_mark_for_recycle(skb);
+#else
+	/* No recycling support in stack, disconnect the page from pool */
+	page_pool_release_page(pool->page_pool, page);
+#endif
 }
 
-static struct sk_buff *pfeng_rx_map_buff_to_skb(struct pfeng_rx_chnl_pool *pool, u32 rx_len)
+static void *pfeng_rx_map_buff_pull(struct pfeng_rx_chnl_pool *pool, u32 rx_len)
 {
 	struct pfeng_rx_map *rx_map;
-	struct sk_buff *skb;
-	void *va;
+	void *buf;
 
 	rx_map = pfeng_bman_get_rx_map(pool, pool->rd_idx);
 
 	/* get rx buffer */
 	dma_sync_single_range_for_cpu(pool->dev, rx_map->dma,
-				      rx_map->page_offset,
-				      rx_len, DMA_FROM_DEVICE);
+				      PFE_RXB_PAD,
+				      rx_len, PFE_RXB_DMA_DIR);
 
-	va = page_address(rx_map->page) + rx_map->page_offset;
-	skb = build_skb(va - PFE_RXB_PAD, PFE_RXB_TRUESIZE);
-	if (unlikely(!skb))
-		return NULL;
+	buf = page_address(rx_map->page) + PFE_RXB_PAD;
 
-	skb_reserve(skb, PFE_RXB_PAD);
-	__skb_put(skb, rx_len);
-
-	/* put rx buffer */
-	if (likely(pfeng_page_reusable(rx_map->page))) {
-		rx_map->page_offset ^= PFE_RXB_TRUESIZE;
-		page_ref_inc(rx_map->page);
-
-		pfeng_reuse_page(pool, rx_map);
-
-		/* dma sync for use by device */
-		dma_sync_single_range_for_device(pool->dev, rx_map->dma,
-						 rx_map->page_offset,
-						 PFE_RXB_DMA_SIZE,
-						 DMA_FROM_DEVICE);
-	} else {
-		dma_unmap_page(pool->dev, rx_map->dma, PAGE_SIZE, DMA_FROM_DEVICE);
-	}
-
-	/* drop reference as page was reused at alloc_idx, or was unmaped */
+	/* page is owned by caller now */
 	rx_map->page = NULL;
 	/* pull rx map */
 	pool->rd_idx++;
 
-	return skb;
+	return buf;
 }
 
-struct sk_buff *pfeng_hif_chnl_receive_pkt(struct pfeng_hif_chnl *chnl, u32 queue)
+/**
+ * @brief	Get next received buffer from the RX ring
+ * @details	Ring is read in bursts, buffers left at the end of NAPI poll
+ *		are returned by the next one
+ * @param[in]	chnl The HIF channel
+ * @return	The ring buffer or NULL if there is nothing to receive
+ */
+static inline pfe_hif_ring_buf_t *pfeng_bman_rx_next(struct pfeng_hif_chnl *chnl)
 {
-	struct sk_buff *skb;
-	void *buf_pa;
-	u32 rx_len;
-	bool_t lifm;
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
 
-	if (unlikely(pfeng_bman_rx_chnl_pool_unused(chnl->bman.rx_pool) >= PFENG_BMAN_REFILL_THR))
-		pfeng_hif_chnl_refill_rx_pool(chnl, PFENG_BMAN_REFILL_THR);
+	if (pool->burst_idx == pool->burst_cnt) {
+		pfeng_bman_rx_owner_check(chnl);
+		pool->burst_idx = 0;
+		pool->burst_cnt = pfe_hif_chnl_rx_burst(pool->chnl, pool->burst, PFENG_BMAN_RX_BURST);
+		if (!pool->burst_cnt)
+			return NULL;
+	}
+
+	return &pool->burst[pool->burst_idx++];
+}
+
+/**
+ * @brief	Get received buffer from HIF channel
+ * @details	First buffer of a frame starts with pfe_ct_hif_rx_hdr_t, the
+ *		following buffers of a jumbo frame carry data only. Caller owns
+ *		the buffer and has to turn it into skb or release it.
+ * @param[in]	chnl The HIF channel
+ * @param[out]	len Length of received data including HIF header
+ * @param[out]	lifm True if the buffer is the last one of the frame
+ * @return	Buffer VA or NULL if there is nothing to receive
+ */
+void *pfeng_hif_chnl_receive_buf(struct pfeng_hif_chnl *chnl, u32 *len, bool *lifm)
+{
+	pfe_hif_ring_buf_t *rx;
+	void *buf;
 
 	/*	Get RX buffer */
-	if (EOK != pfe_hif_chnl_rx(chnl->priv, &buf_pa, &rx_len, &lifm))
-	{
+	rx = pfeng_bman_rx_next(chnl);
+	if (!rx)
 		return NULL;
-	}
 
 	/*  Get buffer VA */
-	skb = pfeng_rx_map_buff_to_skb(chnl->bman.rx_pool, rx_len);
+	buf = pfeng_rx_map_buff_pull(chnl->bman.rx_pool, rx->len);
+	prefetch(buf);
+	*len = rx->len;
+	*lifm = !!rx->lifm;
+
+	return buf;
+}
+
+/**
+ * @brief	Build skb around received buffer
+ * @param[in]	chnl The HIF channel
+ * @param[in]	data Start of the skb data within the buffer
+ * @param[in]	len Length of the skb data
+ * @return	The skb or NULL if failed. Buffer is released in such case.
+ */
+struct sk_buff *pfeng_bman_build_skb(struct pfeng_hif_chnl *chnl, void *data, u32 len)
+{
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
+	struct page *page = virt_to_head_page(data);
+	void *va = page_address(page);
+	struct sk_buff *skb;
+
+	skb = build_skb(va, PFE_RXB_TRUESIZE);
 	if (unlikely(!skb)) {
-		dev_err(chnl->dev, "chnl%d: pull VA failed\n", chnl->idx);
+		dev_err(chnl->dev, "chnl%d: build skb failed\n", chnl->idx);
+		/* Buffer is consumed by HIF anyway, give the page back */
+		page_pool_recycle_direct(pool->page_pool, page);
 		return NULL;
 	}
-	prefetch(skb->data);
+
+	skb_reserve(skb, data - va);
+	__skb_put(skb, len);
+	pfeng_bman_skb_mark_for_recycle(pool, skb, page);
 
 	return skb;
 }
 
-int pfeng_hif_chnl_fill_rx_buffers(struct pfeng_hif_chnl *chnl)
+/**
+ * @brief	Attach next buffer of a jumbo frame to the skb
+ * @param[in]	chnl The HIF channel
+ * @param[in]	skb The skb built from the first buffer of the frame
+ * @param[in]	data The received buffer
+ * @param[in]	len Length of the received data
+ * @return	0 if OK, -E2BIG if the skb is full. Buffer is released in such case.
+ */
+int pfeng_bman_skb_add_frag(struct pfeng_hif_chnl *chnl, struct sk_buff *skb, void *data, u32 len)
 {
-	int cnt = 0;
-	int ret;
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
+	struct page *page = virt_to_head_page(data);
 
-	while (pfe_hif_chnl_can_accept_rx_buf(chnl->priv)) {
+	if (unlikely(skb_shinfo(skb)->nr_frags >= MAX_SKB_FRAGS)) {
+		page_pool_recycle_direct(pool->page_pool, page);
+		return -E2BIG;
+	}
 
-		preempt_disable();
-		ret = pfeng_hif_chnl_refill_rx_pool(chnl, 1);
-		preempt_enable();
-		if (ret)
-			break;
-		cnt++;
+	skb_add_rx_frag(skb, skb_shinfo(skb)->nr_frags, page, data - page_address(page),
+			len, PFE_RXB_TRUESIZE);
+#if LINUX_VERSION_CODE < KERNEL_VERSION(5,15,0)
+	/* No recycling support in stack, disconnect the page from pool */
+	page_pool_release_page(pool->page_pool, page);
+#endif
+
+	return 0;
+}
+
+/* Return received buffer to page_pool, RX NAPI context only */
+void pfeng_bman_free_buf(struct pfeng_hif_chnl *chnl, void *data)
+{
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
+
+	page_pool_recycle_direct(pool->page_pool, virt_to_head_page(data));
+}
+
+/**
+ * @brief	Prepare XDP buffer for received buffer
+ * @details	XDP program sees the frame without HIF header
+ * @param[in]	chnl The HIF channel
+ * @param[out]	xdp The XDP buffer
+ * @param[in]	buf Received buffer, starting with HIF header
+ * @param[in]	len Length of received data including HIF header
+ * @param[in]	rxq XDP RX queue info of receiving netif
+ */
+void pfeng_bman_xdp_buff_init(struct pfeng_hif_chnl *chnl, struct xdp_buff *xdp, void *buf, u32 len, struct xdp_rxq_info *rxq)
+{
+	xdp->data_hard_start = buf - PFE_RXB_PAD;
+	xdp->data = buf + sizeof(pfe_ct_hif_rx_hdr_t);
+	xdp->data_end = buf + len;
+	xdp_set_data_meta_invalid(xdp);
+	xdp->rxq = rxq;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,8,0)
+	xdp->frame_sz = PFE_RXB_TRUESIZE;
+#endif
+}
+
+/* Hand page_pool owned data over to HIF TX */
+dma_addr_t pfeng_bman_buf_sync_for_tx(struct pfeng_hif_chnl *chnl, void *data, u32 len)
+{
+	dma_addr_t dma = page_pool_get_dma_addr(virt_to_head_page(data)) + offset_in_page(data);
+
+	dma_sync_single_for_device(chnl->dev, dma, len, PFE_RXB_DMA_DIR);
+
+	return dma;
+}
+
+struct page_pool *pfeng_bman_page_pool(struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
+
+	return pool->page_pool;
+}
+
+/**
+ * @brief	Release all RX buffers owned by the RX ring
+ * @details	HIF channel RX ring has to be drained by pfe_hif_chnl_rx_drain() first
+ * @param[in]	chnl The HIF channel
+ */
+void pfeng_bman_rx_release_all(struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
+	struct pfeng_rx_map *rx_map;
+	u32 i;
+
+	for (i = 0; i < pool->depth; i++) {
+		rx_map = &pool->rx_tbl[i];
+		if (rx_map->page) {
+			page_pool_put_full_page(pool->page_pool, rx_map->page, false);
+			rx_map->page = NULL;
+		}
+#ifdef PFENG_CFG_XSK_SUPPORT
+		if (rx_map->xsk) {
+			xsk_buff_free(rx_map->xsk);
+			rx_map->xsk = NULL;
+		}
+#endif /* PFENG_CFG_XSK_SUPPORT */
 	}
 
-	return cnt;
+	/* Drop incomplete jumbo frame, the rest of it is gone with the ring */
+	if (chnl->rx_skb) {
+		kfree_skb(chnl->rx_skb);
+		chnl->rx_skb = NULL;
+	}
+	chnl->rx_skb_discard = false;
+
+	/* Ring is empty, start over */
+	pool->rd_idx = 0;
+	pool->wr_idx = 0;
+	pool->burst_idx = 0;
+	pool->burst_cnt = 0;
+}
+
+#ifdef PFENG_CFG_XSK_SUPPORT
+/**
+ * @brief	Get received AF_XDP buffer from HIF channel
+ * @details	Buffer data starts with pfe_ct_hif_rx_hdr_t
+ * @param[in]	chnl The HIF channel in AF_XDP zero-copy mode
+ * @param[out]	len Length of received data including HIF header
+ * @param[out]	lifm False if more buffers of the frame follow
+ * @return	The XSK buffer or NULL if there is nothing to receive
+ */
+struct xdp_buff *pfeng_hif_chnl_receive_xsk(struct pfeng_hif_chnl *chnl, u32 *len, bool *lifm)
+{
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
+	struct pfeng_rx_map *rx_map;
+	struct xdp_buff *xdp;
+	pfe_hif_ring_buf_t *rx;
+	u32 rx_len;
+
+	rx = pfeng_bman_rx_next(chnl);
+	if (!rx)
+		return NULL;
+	rx_len = rx->len;
+
+	rx_map = pfeng_bman_get_rx_map(pool, pool->rd_idx);
+	xdp = rx_map->xsk;
+	/* buffer is owned by caller now */
+	rx_map->xsk = NULL;
+	/* pull rx map */
+	pool->rd_idx++;
+
+	xdp->data_end = xdp->data + rx_len;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6,10,0)
+	xsk_buff_dma_sync_for_cpu(xdp);
+#else
+	xsk_buff_dma_sync_for_cpu(xdp, chnl->xsk_pool);
+#endif
+	*len = rx_len;
+	*lifm = rx->lifm;
+
+	return xdp;
+}
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
+/**
+ * @brief	Fill all free slots of the RX ring
+ * @details	Caller has to trigger the RX DMA if anything was supplied
+ * @param[in]	chnl The HIF channel, RX NAPI is not running or is the caller
+ * @return	Number of buffers supplied
+ */
+int pfeng_hif_chnl_fill_rx_buffers(struct pfeng_hif_chnl *chnl)
+{
+	return pfeng_hif_chnl_refill_rx_pool(chnl, pfeng_bman_rx_chnl_pool_unused(chnl->bman.rx_pool));
+}
+
+/**
+ * @brief	Refill the RX ring at the end of NAPI poll
+ * @details	Nothing is done until the number of free slots reaches the
+ *		threshold, then all of them are filled at once. Caller has to
+ *		trigger the RX DMA if anything was supplied.
+ * @param[in]	chnl The HIF channel
+ * @return	Number of buffers supplied
+ */
+int pfeng_hif_chnl_refill_rx_buffers(struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
+	int unused = pfeng_bman_rx_chnl_pool_unused(pool);
+
+	if (unused < pool->refill_thr)
+		return 0;
+
+	return pfeng_hif_chnl_refill_rx_pool(chnl, unused);
+}
+
+/**
+ * @brief	Print RX buffer pool statistics
+ * @param[in]	seq The seq_file to print to
+ * @param[in]	chnl The HIF channel
+ */
+void pfeng_bman_get_stats(struct pfeng_hif_chnl *chnl, struct pfeng_bman_stats *stats)
+{
+	struct pfeng_rx_chnl_pool *rx_pool = chnl->bman.rx_pool;
+	struct pfeng_tx_chnl_pool *tx_pool = chnl->bman.tx_pool;
+#ifdef CONFIG_PAGE_POOL_STATS
+	struct page_pool_stats pp_stats = { 0 };
+#endif
+
+	memset(stats, 0, sizeof(*stats));
+
+	if (tx_pool)
+		stats->tx_ring_used = (tx_pool->wr_idx - tx_pool->rd_idx) & tx_pool->idx_mask;
+
+	if (!rx_pool)
+		return;
+
+	stats->rx_ring_used = rx_pool->wr_idx - rx_pool->rd_idx;
+	stats->rx_alloc_err = rx_pool->alloc_err;
+	stats->rx_refills = rx_pool->refills;
+	stats->rx_refill_starved = rx_pool->refill_starved;
+
+#ifdef CONFIG_PAGE_POOL_STATS
+	if (!rx_pool->page_pool || !page_pool_get_stats(rx_pool->page_pool, &pp_stats))
+		return;
+
+	stats->pp_alloc_fast = pp_stats.alloc_stats.fast;
+	stats->pp_alloc_slow = pp_stats.alloc_stats.slow + pp_stats.alloc_stats.slow_high_order;
+	stats->pp_recycle_cached = pp_stats.recycle_stats.cached;
+	stats->pp_recycle_ring = pp_stats.recycle_stats.ring;
+	stats->pp_recycle_released = pp_stats.recycle_stats.released_refcnt;
+#endif /* CONFIG_PAGE_POOL_STATS */
+}
+
+void pfeng_bman_rx_pool_show(struct seq_file *seq, struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_rx_chnl_pool *pool = chnl->bman.rx_pool;
+#ifdef CONFIG_PAGE_POOL_STATS
+	struct page_pool_stats stats = { 0 };
+#endif
+
+	if (!pool)
+		return;
+
+	seq_printf(seq, "depth: %u buffers in ring: %u alloc errors: %llu\n",
+		   pool->depth, pool->wr_idx - pool->rd_idx, pool->alloc_err);
+	seq_printf(seq, "refill threshold: %u refills: %llu starved: %llu\n",
+		   pool->refill_thr, pool->refills, pool->refill_starved);
+
+#ifdef CONFIG_PAGE_POOL_STATS
+	if (!page_pool_get_stats(pool->page_pool, &stats))
+		return;
+
+	seq_printf(seq, "alloc fast: %llu slow: %llu slow_high_order: %llu empty: %llu refill: %llu waive: %llu\n",
+		   stats.alloc_stats.fast, stats.alloc_stats.slow, stats.alloc_stats.slow_high_order,
+		   stats.alloc_stats.empty, stats.alloc_stats.refill, stats.alloc_stats.waive);
+	seq_printf(seq, "recycle cached: %llu cache_full: %llu ring: %llu ring_full: %llu released_refcnt: %llu\n",
+		   stats.recycle_stats.cached, stats.recycle_stats.cache_full, stats.recycle_stats.ring,
+		   stats.recycle_stats.ring_full, stats.recycle_stats.released_refcnt);
+#endif /* CONFIG_PAGE_POOL_STATS */
 }
@@ -66,6 +66,25 @@ CREATE_DEBUGFS_ENTRY_TYPE(fp);
 #endif
 CREATE_DEBUGFS_ENTRY_TYPE(hif_chnl);
 
+static int pfeng_rx_pool_debug_show(struct seq_file *seq, void *v)
+{
+	pfeng_bman_rx_pool_show(seq, seq->private);
+
+	return 0;
+}
+
+static int pfeng_rx_pool_stats_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, pfeng_rx_pool_debug_show, inode->i_private);
+}
+
+static const struct file_operations pfeng_rx_pool_fops = {
+	.open		= pfeng_rx_pool_stats_open,
+	.read		= seq_read,
+	.llseek		= seq_lseek,
+	.release	= single_release,
+};
+
 #define ADD_DEBUGFS_ENTRY(ename, etype, parent, epriv, esav)			\
 	{									\
 		struct dentry *dptr;						\
@@ -143,6 +162,10 @@ int pfeng_debugfs_add_hif_chnl(struct pfeng_priv *priv, u32 idx)
 	/* add members to the subdirectory */
 	ADD_DEBUGFS_ENTRY(fname, hif_chnl, priv->dbgfs, chnl->priv, &dsav);
 
+	/* RX buffer pool */
+	scnprintf(fname, sizeof(fname), "hif%d_rx_pool", idx);
+	ADD_DEBUGFS_ENTRY(fname, rx_pool, priv->dbgfs, chnl, &dsav);
+
 	return 0;
 }
 
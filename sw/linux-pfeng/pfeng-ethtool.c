@@ -11,6 +11,7 @@
 #include <linux/clk.h>
 #include <linux/etherdevice.h>
 #include <linux/ethtool.h>
+#include <linux/log2.h>
 #include <linux/phylink.h>
 
 static void pfeng_ethtool_getdrvinfo(struct net_device *netdev, struct ethtool_drvinfo *info)
@@ -126,6 +127,9 @@ static int pfeng_get_coalesce(struct net_device *netdev, struct ethtool_coalesce
 
 	ec->rx_max_coalesced_frames = frames;
 	ec->rx_coalesce_usecs = DIV_ROUND_UP(cycles, DIV_ROUND_UP(clk_get_rate(netif->priv->clk_sys), USEC_PER_SEC));
+#ifdef PFENG_CFG_DIM_SUPPORT
+	ec->use_adaptive_rx_coalesce = chnl->rx_dim_en;
+#endif /* PFENG_CFG_DIM_SUPPORT */
 
 	return 0;
 }
@@ -138,6 +142,22 @@ static int pfeng_set_coalesce(struct net_device *netdev, struct ethtool_coalesce
 	u64 cycles = 0;
 	int ret = 0;
 
+#ifdef PFENG_CFG_DIM_SUPPORT
+	/* DIM owns the coalescing timer, static values are applied once it is turned off */
+	for (idx = 0; idx < PFENG_PFE_HIF_CHANNELS; idx++) {
+		if (!(netif->cfg->hifmap & (1 << idx)))
+			continue;
+
+		pfeng_hif_chnl_rx_dim_enable(&netif->priv->hif_chnl[idx], ec->use_adaptive_rx_coalesce);
+	}
+
+	if (ec->use_adaptive_rx_coalesce)
+		return 0;
+#else
+	if (ec->use_adaptive_rx_coalesce)
+		return -EOPNOTSUPP;
+#endif /* PFENG_CFG_DIM_SUPPORT */
+
 	/* Right now we only support two modes:
 	 * 1) disabled coalescing
 	 * 2) time-triggered coalescing
@@ -169,10 +189,529 @@ static int pfeng_set_coalesce(struct net_device *netdev, struct ethtool_coalesce
 	return ret;
 }
 
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,17,0)
+static void pfeng_ethtool_get_ringparam(struct net_device *netdev, struct ethtool_ringparam *ring,
+					struct kernel_ethtool_ringparam *kring, struct netlink_ext_ack *extack)
+#else
+static void pfeng_ethtool_get_ringparam(struct net_device *netdev, struct ethtool_ringparam *ring)
+#endif
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+	struct pfeng_hif_chnl *chnl;
+
+	/* All HIF channels are using the same setting, so use first one */
+	chnl = &netif->priv->hif_chnl[ffs(netif->cfg->hifmap) - 1];
+
+	ring->rx_max_pending = PFE_HIF_RING_CFG_LENGTH_MAX;
+	ring->tx_max_pending = PFE_HIF_RING_CFG_LENGTH_MAX;
+	ring->rx_pending = pfe_hif_chnl_get_rx_fifo_depth(chnl->priv);
+	ring->tx_pending = pfe_hif_chnl_get_tx_fifo_depth(chnl->priv);
+}
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,17,0)
+static int pfeng_ethtool_set_ringparam(struct net_device *netdev, struct ethtool_ringparam *ring,
+				       struct kernel_ethtool_ringparam *kring, struct netlink_ext_ack *extack)
+#else
+static int pfeng_ethtool_set_ringparam(struct net_device *netdev, struct ethtool_ringparam *ring)
+#endif
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+	u32 rx_len[PFENG_PFE_HIF_CHANNELS], tx_len[PFENG_PFE_HIF_CHANNELS];
+	struct pfeng_hif_chnl *chnl;
+	u32 idx;
+	int ret = 0;
+
+	if (ring->rx_mini_pending || ring->rx_jumbo_pending)
+		return -EINVAL;
+
+	if (ring->rx_pending < PFE_HIF_RING_CFG_LENGTH_MIN || !is_power_of_2(ring->rx_pending) ||
+	    ring->tx_pending < PFE_HIF_RING_CFG_LENGTH_MIN || !is_power_of_2(ring->tx_pending)) {
+		netdev_err(netdev, "Ring length must be power of 2 within %u..%u\n",
+			   PFE_HIF_RING_CFG_LENGTH_MIN, PFE_HIF_RING_CFG_LENGTH_MAX);
+		return -EINVAL;
+	}
+
+	/* Setup all linked HIF channels. Shared channel affects all its netifs. */
+	for (idx = 0; idx < PFENG_PFE_HIF_CHANNELS; idx++) {
+		if (!(netif->cfg->hifmap & (1 << idx)))
+			continue;
+
+		chnl = &netif->priv->hif_chnl[idx];
+		rx_len[idx] = pfe_hif_chnl_get_rx_fifo_depth(chnl->priv);
+		tx_len[idx] = pfe_hif_chnl_get_tx_fifo_depth(chnl->priv);
+		ret = pfeng_hif_chnl_set_ring_len(chnl, ring->rx_pending, ring->tx_pending);
+		if (ret)
+			break;
+	}
+
+	/* Failed channel is left as it was, return the ones resized before */
+	if (ret) {
+		while (idx--) {
+			if (!(netif->cfg->hifmap & (1 << idx)))
+				continue;
+
+			if (pfeng_hif_chnl_set_ring_len(&netif->priv->hif_chnl[idx], rx_len[idx], tx_len[idx]))
+				netdev_err(netdev, "HIF%u ring length can't be restored\n", idx);
+		}
+	}
+
+	return ret;
+}
+
+static int pfeng_ethtool_get_tunable(struct net_device *netdev, const struct ethtool_tunable *tuna, void *data)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	switch (tuna->id) {
+	case ETHTOOL_TX_COPYBREAK:
+		*(u32 *)data = READ_ONCE(netif->tx_copybreak);
+		return 0;
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
+static int pfeng_ethtool_set_tunable(struct net_device *netdev, const struct ethtool_tunable *tuna, const void *data)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+	u32 val;
+
+	switch (tuna->id) {
+	case ETHTOOL_TX_COPYBREAK:
+		val = *(const u32 *)data;
+		if (val > PFENG_TX_COPYBREAK_MAX) {
+			netdev_err(netdev, "TX copybreak is limited to %zu bytes\n", PFENG_TX_COPYBREAK_MAX);
+			return -EINVAL;
+		}
+		WRITE_ONCE(netif->tx_copybreak, val);
+		return 0;
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
+#ifdef PFE_CFG_PFE_MASTER
+static int pfeng_ethtool_get_rxnfc(struct net_device *netdev, struct ethtool_rxnfc *rxnfc, u32 *rule_locs)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	switch (rxnfc->cmd) {
+	case ETHTOOL_GRXRINGS:
+		rxnfc->data = netif->cfg->hifs;
+		return 0;
+	case ETHTOOL_GRXCLSRLCNT:
+		rxnfc->rule_cnt = pfeng_ntuple_get_count(netif);
+		rxnfc->data = PFENG_NTUPLE_RULES;
+		return 0;
+	case ETHTOOL_GRXCLSRULE:
+		return pfeng_ntuple_get_rule(netif, &rxnfc->fs);
+	case ETHTOOL_GRXCLSRLALL:
+		rxnfc->data = PFENG_NTUPLE_RULES;
+		return pfeng_ntuple_get_all(netif, rule_locs, &rxnfc->rule_cnt);
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
+static int pfeng_ethtool_set_rxnfc(struct net_device *netdev, struct ethtool_rxnfc *rxnfc)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	switch (rxnfc->cmd) {
+	case ETHTOOL_SRXCLSRLINS:
+		return pfeng_ntuple_add(netif, &rxnfc->fs);
+	case ETHTOOL_SRXCLSRLDEL:
+		return pfeng_ntuple_del(netif, rxnfc->fs.location);
+	default:
+		return -EOPNOTSUPP;
+	}
+}
+
+/* Each HIF channel is one RX/TX queue pair of the netif */
+static void pfeng_ethtool_get_channels(struct net_device *netdev, struct ethtool_channels *ch)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	ch->max_combined = pfeng_netif_get_max_hifs(netif);
+	ch->combined_count = netif->cfg->hifs;
+}
+
+static int pfeng_ethtool_set_channels(struct net_device *netdev, struct ethtool_channels *ch)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	if (ch->rx_count || ch->tx_count || ch->other_count)
+		return -EINVAL;
+
+	if (!ch->combined_count)
+		return -EINVAL;
+
+	return pfeng_netif_set_hifs(netif, ch->combined_count);
+}
+
+static u32 pfeng_ethtool_get_rxfh_indir_size(struct net_device *netdev)
+{
+	return pfeng_rss_get_indir_size(netdev_priv(netdev));
+}
+
+/* There is no hash key, flow bucket is taken from L4 ports directly */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6,8,0)
+static int pfeng_ethtool_get_rxfh(struct net_device *netdev, struct ethtool_rxfh_param *rxfh)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	rxfh->hfunc = ETH_RSS_HASH_UNKNOWN;
+	if (rxfh->indir)
+		pfeng_rss_get_indir(netif, rxfh->indir);
+
+	return 0;
+}
+
+static int pfeng_ethtool_set_rxfh(struct net_device *netdev, struct ethtool_rxfh_param *rxfh,
+				  struct netlink_ext_ack *extack)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	if (rxfh->key || rxfh->hfunc != ETH_RSS_HASH_NO_CHANGE)
+		return -EOPNOTSUPP;
+
+	if (!rxfh->indir)
+		return 0;
+
+	return pfeng_rss_set_indir(netif, rxfh->indir);
+}
+#else
+static int pfeng_ethtool_get_rxfh(struct net_device *netdev, u32 *indir, u8 *key, u8 *hfunc)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	if (hfunc)
+		*hfunc = ETH_RSS_HASH_UNKNOWN;
+	if (indir)
+		pfeng_rss_get_indir(netif, indir);
+
+	return 0;
+}
+
+static int pfeng_ethtool_set_rxfh(struct net_device *netdev, const u32 *indir, const u8 *key, const u8 hfunc)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	if (key || hfunc != ETH_RSS_HASH_NO_CHANGE)
+		return -EOPNOTSUPP;
+
+	if (!indir)
+		return 0;
+
+	return pfeng_rss_set_indir(netif, indir);
+}
+#endif
+#endif /* PFE_CFG_PFE_MASTER */
+
+/* per TX queue counters, see struct pfeng_txq_stats */
+static const char pfeng_txq_stats_str[][ETH_GSTRING_LEN] = {
+	"packets",
+	"bytes",
+	"dropped",
+	"ring_full",
+	"chnl_down",
+	"overlimited",
+	"dma_map_failed",
+	"copybreak",
+};
+
+/* per RX queue counters, see struct pfeng_rxq_stats */
+static const char pfeng_rxq_stats_str[][ETH_GSTRING_LEN] = {
+	"packets",
+	"bytes",
+	"dropped",
+};
+
+/* per HIF channel counters, see struct pfeng_bman_stats */
+static const char pfeng_hif_stats_str[][ETH_GSTRING_LEN] = {
+	"rx_ring_used",
+	"tx_ring_used",
+	"rx_alloc_err",
+	"rx_refills",
+	"rx_refill_starved",
+	"pp_alloc_fast",
+	"pp_alloc_slow",
+	"pp_recycle_cached",
+	"pp_recycle_ring",
+	"pp_recycle_released",
+};
+
+/* firmware and EMAC counters, see struct pfeng_hw_stats_raw */
+static const char pfeng_hw_stats_str[][ETH_GSTRING_LEN] = {
+	"phy_ingress",
+	"phy_egress",
+	"phy_malformed",
+	"phy_discarded",
+	"logif_processed",
+	"logif_accepted",
+	"logif_rejected",
+	"logif_discarded",
+	"mac_tx_octet_count_good_bad",
+	"mac_tx_packet_count_good_bad",
+	"mac_tx_broadcast_packets_good",
+	"mac_tx_multicast_packets_good",
+	"mac_tx_64octets_packets_good_bad",
+	"mac_tx_65to127octets_packets_good_bad",
+	"mac_tx_128to255octets_packets_good_bad",
+	"mac_tx_256to511octets_packets_good_bad",
+	"mac_tx_512to1023octets_packets_good_bad",
+	"mac_tx_1024tomaxoctets_packets_good_bad",
+	"mac_tx_unicast_packets_good_bad",
+	"mac_tx_multicast_packets_good_bad",
+	"mac_tx_broadcast_packets_good_bad",
+	"mac_tx_underflow_error_packets",
+	"mac_tx_single_collision_good_packets",
+	"mac_tx_multiple_collision_good_packets",
+	"mac_tx_deferred_packets",
+	"mac_tx_late_collision_packets",
+	"mac_tx_excessive_collision_packets",
+	"mac_tx_carrier_error_packets",
+	"mac_tx_octet_count_good",
+	"mac_tx_packet_count_good",
+	"mac_tx_excessive_deferral_error",
+	"mac_tx_pause_packets",
+	"mac_tx_vlan_packets_good",
+	"mac_tx_osize_packets_good",
+	"mac_rx_packets_count_good_bad",
+	"mac_rx_octet_count_good_bad",
+	"mac_rx_octet_count_good",
+	"mac_rx_broadcast_packets_good",
+	"mac_rx_multicast_packets_good",
+	"mac_rx_crc_error_packets",
+	"mac_rx_alignment_error_packets",
+	"mac_rx_runt_error_packets",
+	"mac_rx_jabber_error_packets",
+	"mac_rx_undersize_packets_good",
+	"mac_rx_oversize_packets_good",
+	"mac_rx_64octets_packets_good_bad",
+	"mac_rx_65to127octets_packets_good_bad",
+	"mac_rx_128to255octets_packets_good_bad",
+	"mac_rx_256to511octets_packets_good_bad",
+	"mac_rx_512to1023octets_packets_good_bad",
+	"mac_rx_1024tomaxoctets_packets_good_bad",
+	"mac_rx_unicast_packets_good",
+	"mac_rx_length_error_packets",
+	"mac_rx_out_of_range_type_packets",
+	"mac_rx_pause_packets",
+	"mac_rx_fifo_overflow_packets",
+	"mac_rx_vlan_packets_good_bad",
+	"mac_rx_watchdog_error_packets",
+	"mac_rx_receive_error_packets",
+	"mac_rx_control_packets_good",
+};
+
+/* TX time stamp counters, see struct pfeng_hwts_stats */
+static const char pfeng_hwts_stats_str[][ETH_GSTRING_LEN] = {
+	"hwts_tx_requested",
+	"hwts_tx_matched",
+	"hwts_tx_skipped",
+	"hwts_tx_unknown",
+	"hwts_tx_aged",
+	"hwts_tx_lat_max_ns",
+	"hwts_tx_lat_avg_ns",
+};
+
+#define PFENG_TXQ_STATS_NUM	ARRAY_SIZE(pfeng_txq_stats_str)
+#define PFENG_RXQ_STATS_NUM	ARRAY_SIZE(pfeng_rxq_stats_str)
+#define PFENG_HIF_STATS_NUM	ARRAY_SIZE(pfeng_hif_stats_str)
+#define PFENG_HWTS_STATS_NUM	ARRAY_SIZE(pfeng_hwts_stats_str)
+#define PFENG_QUEUE_STATS_NUM	(PFENG_TXQ_STATS_NUM + PFENG_RXQ_STATS_NUM + PFENG_HIF_STATS_NUM)
+
+static void pfeng_hw_stats_fold(struct pfeng_hw_stats *hw, size_t off, const void *raw, size_t size)
+{
+	const u32 *cnt = raw;
+	u32 i, idx = off / sizeof(u32);
+
+	/* 32-bit free running counters, only the delta since last read is added */
+	for (i = 0; i < size / sizeof(u32); i++, idx++) {
+		hw->acc[idx] += (u32)(cnt[i] - hw->last[idx]);
+		hw->last[idx] = cnt[i];
+	}
+}
+
+/**
+ * @brief	Fold current firmware and EMAC counters into 64-bit accumulators
+ * @details	Sources not available right now keep their accumulated values.
+ * @param[in]	netif Net interface instance
+ */
+static void pfeng_hw_stats_update(struct pfeng_netif *netif)
+{
+	struct pfeng_hw_stats *hw = &netif->hw_stats;
+	struct pfeng_emac *emac = &netif->priv->emac[netif->cfg->emac];
+	pfe_emac_t *pfe_emac = netif->priv->pfe_platform->emac[netif->cfg->emac];
+	struct pfeng_hw_stats_raw raw;
+
+	mutex_lock(&hw->lock);
+
+	if (!hw->enabled)
+		goto out;
+
+	if (emac->phyif_emac && pfe_phy_if_get_stats(emac->phyif_emac, &raw.phy_if) == EOK)
+		pfeng_hw_stats_fold(hw, offsetof(struct pfeng_hw_stats_raw, phy_if), &raw.phy_if, sizeof(raw.phy_if));
+
+	if (emac->logif_emac && pfe_log_if_get_stats(emac->logif_emac, &raw.log_if) == EOK)
+		pfeng_hw_stats_fold(hw, offsetof(struct pfeng_hw_stats_raw, log_if), &raw.log_if, sizeof(raw.log_if));
+
+	if (pfe_emac && pfe_emac_get_rmon_stats(pfe_emac, &raw.mac) == EOK)
+		pfeng_hw_stats_fold(hw, offsetof(struct pfeng_hw_stats_raw, mac), &raw.mac, sizeof(raw.mac));
+
+out:
+	mutex_unlock(&hw->lock);
+}
+
+static void pfeng_hw_stats_work(struct work_struct *work)
+{
+	struct pfeng_netif *netif = container_of(to_delayed_work(work), struct pfeng_netif, hw_stats.work);
+
+	pfeng_hw_stats_update(netif);
+	schedule_delayed_work(&netif->hw_stats.work, PFENG_HW_STATS_PERIOD);
+}
+
+/**
+ * @brief	Start periodic accumulation of firmware and EMAC counters
+ * @details	Counters are re-read from zero, as the platform interfaces
+ *		are (re)created before the call.
+ * @param[in]	netif Net interface instance
+ */
+void pfeng_ethtool_stats_start(struct pfeng_netif *netif)
+{
+	struct pfeng_hw_stats *hw = &netif->hw_stats;
+
+	mutex_lock(&hw->lock);
+	memset(hw->last, 0, sizeof(hw->last));
+	hw->enabled = true;
+	mutex_unlock(&hw->lock);
+
+	schedule_delayed_work(&hw->work, 0);
+}
+
+/**
+ * @brief	Stop periodic accumulation of firmware and EMAC counters
+ * @details	Must be called while the platform interfaces are still valid,
+ *		the last values are folded in before the interfaces go away.
+ * @param[in]	netif Net interface instance
+ */
+void pfeng_ethtool_stats_stop(struct pfeng_netif *netif)
+{
+	struct pfeng_hw_stats *hw = &netif->hw_stats;
+
+	if (!READ_ONCE(hw->enabled))
+		return;
+
+	cancel_delayed_work_sync(&hw->work);
+	pfeng_hw_stats_update(netif);
+
+	mutex_lock(&hw->lock);
+	hw->enabled = false;
+	mutex_unlock(&hw->lock);
+}
+
+static int pfeng_ethtool_get_sset_count(struct net_device *netdev, int sset)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	if (sset != ETH_SS_STATS)
+		return -EOPNOTSUPP;
+
+	return netif->cfg->hifs * PFENG_QUEUE_STATS_NUM + PFENG_HW_STATS_NUM + PFENG_HWTS_STATS_NUM;
+}
+
+static void pfeng_ethtool_get_strings(struct net_device *netdev, u32 sset, u8 *data)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+	u32 q, i;
+
+	if (sset != ETH_SS_STATS)
+		return;
+
+	for (q = 0; q < netif->cfg->hifs; q++) {
+		for (i = 0; i < PFENG_TXQ_STATS_NUM; i++) {
+			snprintf(data, ETH_GSTRING_LEN, "txq%u_%s", q, pfeng_txq_stats_str[i]);
+			data += ETH_GSTRING_LEN;
+		}
+		for (i = 0; i < PFENG_RXQ_STATS_NUM; i++) {
+			snprintf(data, ETH_GSTRING_LEN, "rxq%u_%s", q, pfeng_rxq_stats_str[i]);
+			data += ETH_GSTRING_LEN;
+		}
+		for (i = 0; i < PFENG_HIF_STATS_NUM; i++) {
+			snprintf(data, ETH_GSTRING_LEN, "hif%u_%s", netif->tx_chnl[q], pfeng_hif_stats_str[i]);
+			data += ETH_GSTRING_LEN;
+		}
+	}
+
+	memcpy(data, pfeng_hw_stats_str, sizeof(pfeng_hw_stats_str));
+	data += sizeof(pfeng_hw_stats_str);
+
+	memcpy(data, pfeng_hwts_stats_str, sizeof(pfeng_hwts_stats_str));
+}
+
+static void pfeng_ethtool_get_stats(struct net_device *netdev, struct ethtool_stats *estats, u64 *data)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+	struct pfeng_hw_stats *hw = &netif->hw_stats;
+	struct pfeng_bman_stats bstats;
+	unsigned int start;
+	u32 q;
+
+	BUILD_BUG_ON(ARRAY_SIZE(pfeng_hw_stats_str) != PFENG_HW_STATS_NUM);
+	BUILD_BUG_ON(PFENG_HIF_STATS_NUM != sizeof(struct pfeng_bman_stats) / sizeof(u64));
+	BUILD_BUG_ON(PFENG_HWTS_STATS_NUM != sizeof(struct pfeng_hwts_stats) / sizeof(u64));
+
+	for (q = 0; q < netif->cfg->hifs; q++) {
+		struct pfeng_txq_stats *txq = &netif->txq_stats[q];
+		struct pfeng_rxq_stats *rxq = &netif->rxq_stats[q];
+
+		do {
+			start = u64_stats_fetch_begin(&txq->syncp);
+			data[0] = txq->packets;
+			data[1] = txq->bytes;
+			data[2] = txq->dropped;
+			data[3] = txq->stopped;
+			data[4] = txq->chnl_down;
+			data[5] = txq->overlimited;
+			data[6] = txq->dma_map_failed;
+			data[7] = txq->copybreak;
+		} while (u64_stats_fetch_retry(&txq->syncp, start));
+		data += PFENG_TXQ_STATS_NUM;
+
+		do {
+			start = u64_stats_fetch_begin(&rxq->syncp);
+			data[0] = rxq->packets;
+			data[1] = rxq->bytes;
+			data[2] = rxq->dropped;
+		} while (u64_stats_fetch_retry(&rxq->syncp, start));
+		data += PFENG_RXQ_STATS_NUM;
+
+		pfeng_bman_get_stats(&netif->priv->hif_chnl[netif->tx_chnl[q]], &bstats);
+		memcpy(data, &bstats, sizeof(bstats));
+		data += PFENG_HIF_STATS_NUM;
+	}
+
+	pfeng_hw_stats_update(netif);
+
+	mutex_lock(&hw->lock);
+	memcpy(data, hw->acc, sizeof(hw->acc));
+	mutex_unlock(&hw->lock);
+	data += PFENG_HW_STATS_NUM;
+
+	pfeng_hwts_get_stats(netif, data);
+}
+
 static const struct ethtool_ops pfeng_ethtool_ops = {
 #if LINUX_VERSION_CODE >= KERNEL_VERSION(5,5,0)
+#ifdef PFENG_CFG_DIM_SUPPORT
+	.supported_coalesce_params = ETHTOOL_COALESCE_RX_USECS |
+				     ETHTOOL_COALESCE_RX_MAX_FRAMES |
+				     ETHTOOL_COALESCE_USE_ADAPTIVE_RX,
+#else
 	.supported_coalesce_params = ETHTOOL_COALESCE_RX_USECS |
 				     ETHTOOL_COALESCE_RX_MAX_FRAMES,
+#endif /* PFENG_CFG_DIM_SUPPORT */
 #endif
 	.get_drvinfo = pfeng_ethtool_getdrvinfo,
 	.get_link = ethtool_op_get_link,
@@ -184,10 +723,31 @@ static const struct ethtool_ops pfeng_ethtool_ops = {
 	.get_ts_info = pfeng_ethtool_get_ts_info,
 	.get_coalesce = pfeng_get_coalesce,
 	.set_coalesce = pfeng_set_coalesce,
+	.get_ringparam = pfeng_ethtool_get_ringparam,
+	.set_ringparam = pfeng_ethtool_set_ringparam,
+	.get_tunable = pfeng_ethtool_get_tunable,
+	.set_tunable = pfeng_ethtool_set_tunable,
+	.get_sset_count = pfeng_ethtool_get_sset_count,
+	.get_strings = pfeng_ethtool_get_strings,
+	.get_ethtool_stats = pfeng_ethtool_get_stats,
+#ifdef PFE_CFG_PFE_MASTER
+	.get_rxnfc = pfeng_ethtool_get_rxnfc,
+	.set_rxnfc = pfeng_ethtool_set_rxnfc,
+	.get_rxfh_indir_size = pfeng_ethtool_get_rxfh_indir_size,
+	.get_rxfh = pfeng_ethtool_get_rxfh,
+	.set_rxfh = pfeng_ethtool_set_rxfh,
+	.get_channels = pfeng_ethtool_get_channels,
+	.set_channels = pfeng_ethtool_set_channels,
+#endif /* PFE_CFG_PFE_MASTER */
 
 };
 
 void pfeng_ethtool_init(struct net_device *netdev)
 {
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	mutex_init(&netif->hw_stats.lock);
+	INIT_DELAYED_WORK(&netif->hw_stats.work, pfeng_hw_stats_work);
+
 	netdev->ethtool_ops = &pfeng_ethtool_ops;
 }
@@ -6,6 +6,9 @@
  */
 
 #include <linux/net.h>
+#include <linux/delay.h>
+#include <linux/clk.h>
+#include <net/busy_poll.h>
 
 #include "pfe_cfg.h"
 #include "oal.h"
@@ -14,6 +17,13 @@
 
 #include "pfeng.h"
 
+/* Number of polls waiting for TX ring to be confirmed, 100-200us each */
+#define PFENG_HIF_TX_DRAIN_TRIES	100
+
+static uint napi_threaded;
+module_param(napi_threaded, uint, 0444);
+MODULE_PARM_DESC(napi_threaded, "\t Bitmask of HIF channels polled from own NAPI kthread, default 0");
+
 int pfeng_hif_chnl_stop(struct pfeng_hif_chnl *chnl)
 {
 	/* Disable channel interrupt */
@@ -84,6 +94,22 @@ static void pfeng_hif_drv_chnl_rx_isr(void *arg)
 	}
 }
 
+/**
+ * @brief		HIF channel TX ISR
+ * @details		Will be called by HIF channel instance when TX confirmation is available
+ */
+static void pfeng_hif_drv_chnl_tx_isr(void *arg)
+{
+	struct pfeng_hif_chnl *chnl = (struct pfeng_hif_chnl *)arg;
+
+	if (napi_schedule_prep(&chnl->napi_tx)) {
+
+		pfe_hif_chnl_tx_irq_mask(chnl->priv);
+
+		__napi_schedule_irqoff(&chnl->napi_tx);
+	}
+}
+
 /**
  * @brief		Common HIF channel interrupt service routine
  * @details		Manage common HIF channel interrupt
@@ -105,6 +131,108 @@ static irqreturn_t pfeng_hif_chnl_direct_isr(int irq, void *arg)
 	return IRQ_HANDLED;
 }
 
+void pfeng_hif_chnl_rx_batch_init(struct pfeng_rx_batch *batch)
+{
+	INIT_LIST_HEAD(&batch->gro_list);
+	INIT_LIST_HEAD(&batch->list);
+	memset(batch->pkts, 0, sizeof(batch->pkts));
+	memset(batch->bytes, 0, sizeof(batch->bytes));
+}
+
+/**
+ * @brief	Queue received frame for delivery to the stack
+ * @details	The frame is passed up by pfeng_hif_chnl_rx_flush() at the end of the poll
+ * @param[in]	chnl The receiving HIF channel
+ * @param[in]	netif The destination net interface
+ * @param[in]	skb The frame without HIF header
+ * @param[in]	batch The poll batch
+ */
+void pfeng_hif_chnl_rx_skb(struct pfeng_hif_chnl *chnl, struct pfeng_netif *netif, struct sk_buff *skb, struct pfeng_rx_batch *batch)
+{
+	struct net_device *netdev = netif->netdev;
+
+	skb->dev = netdev;
+
+	/* Cksumming support */
+	if (likely(netdev->features & NETIF_F_RXCSUM)) {
+		/* we have only OK info, signal it */
+		skb->ip_summed = CHECKSUM_UNNECESSARY;
+		/* one level csumming support */
+		skb->csum_level = 0;
+	}
+
+	skb->protocol = eth_type_trans(skb, netdev);
+
+	/* Sockets busy polling on the frame find the channel NAPI by its id */
+	skb_mark_napi_id(skb, &chnl->napi);
+
+	pfeng_rx_batch_count(batch, netif, skb->len);
+
+	/* Frames without checksum info are not worth GRO */
+	if (unlikely(skb->ip_summed == CHECKSUM_NONE))
+		list_add_tail(&skb->list, &batch->list);
+	else
+		list_add_tail(&skb->list, &batch->gro_list);
+}
+
+/**
+ * @brief	Pass frames collected during the poll to the stack and update counters
+ * @param[in]	chnl The receiving HIF channel
+ * @param[in]	batch The poll batch
+ */
+void pfeng_hif_chnl_rx_flush(struct pfeng_hif_chnl *chnl, struct pfeng_rx_batch *batch)
+{
+	struct pfeng_rxq_stats *stats;
+	struct pfeng_netif *netif;
+	struct sk_buff *skb, *tmp;
+	int i;
+
+	list_for_each_entry_safe(skb, tmp, &batch->gro_list, list) {
+		skb_list_del_init(skb);
+		napi_gro_receive(&chnl->napi, skb);
+	}
+
+	if (!list_empty(&batch->list))
+		netif_receive_skb_list(&batch->list);
+
+	for (i = 0; i < HIF_CLIENTS_MAX; i++) {
+		netif = chnl->netifs[i];
+		if (!batch->pkts[i] || !netif)
+			continue;
+
+		stats = pfeng_netif_rxq_stats(netif, chnl);
+		u64_stats_update_begin(&stats->syncp);
+		stats->packets += batch->pkts[i];
+		stats->bytes += batch->bytes[i];
+		u64_stats_update_end(&stats->syncp);
+#ifdef PFENG_CFG_DIM_SUPPORT
+		chnl->rx_dim_pkts += batch->pkts[i];
+		chnl->rx_dim_bytes += batch->bytes[i];
+#endif /* PFENG_CFG_DIM_SUPPORT */
+	}
+}
+
+/* Append buffer to the jumbo frame in progress, returns the skb once complete */
+static struct sk_buff *pfeng_hif_chnl_rx_frag(struct pfeng_hif_chnl *chnl, void *buf, u32 len, bool lifm)
+{
+	struct sk_buff *skb = chnl->rx_skb;
+
+	if (unlikely(pfeng_bman_skb_add_frag(chnl, skb, buf, len))) {
+		pfeng_netif_rxq_stats_drop(chnl->rx_skb_netif, chnl);
+		kfree_skb(skb);
+		chnl->rx_skb = NULL;
+		/* Skip the rest of the frame */
+		chnl->rx_skb_discard = !lifm;
+		return NULL;
+	}
+
+	if (!lifm)
+		return NULL;
+
+	chnl->rx_skb = NULL;
+	return skb;
+}
+
 /**
  * @brief	Process HIF channel receive
  * @details	Read HIF channel data
@@ -116,21 +244,43 @@ static int pfeng_hif_chnl_rx(struct pfeng_hif_chnl *chnl, int limit)
 {
 	pfe_ct_hif_rx_hdr_t *hif_hdr;
 	struct sk_buff *skb;
-	struct net_device *netdev;
 	struct pfeng_netif *netif;
+	struct bpf_prog *xdp_prog;
+	struct pfeng_rx_batch batch;
+	struct xdp_buff xdp;
+	u32 len, xdp_act, xdp_status = 0;
+	bool lifm;
+	void *buf;
 	int done = 0;
 #ifdef PFE_CFG_MULTI_INSTANCE_SUPPORT
 	int ihcs = 0;
 #endif
 
+	pfeng_hif_chnl_rx_batch_init(&batch);
+
 	while (1) {
 
-		skb = pfeng_hif_chnl_receive_pkt(chnl, 0);
-		if (unlikely(!skb))
+		buf = pfeng_hif_chnl_receive_buf(chnl, &len, &lifm);
+		if (unlikely(!buf))
 			/* no more packets */
 			break;
 
-		hif_hdr = (pfe_ct_hif_rx_hdr_t *)skb->data;
+		/* Buffers following the first one of a jumbo frame have no HIF header */
+		if (unlikely(chnl->rx_skb_discard)) {
+			pfeng_bman_free_buf(chnl, buf);
+			chnl->rx_skb_discard = !lifm;
+			continue;
+		}
+
+		if (unlikely(chnl->rx_skb)) {
+			netif = chnl->rx_skb_netif;
+			skb = pfeng_hif_chnl_rx_frag(chnl, buf, len, lifm);
+			if (!skb)
+				continue;
+			goto deliver;
+		}
+
+		hif_hdr = (pfe_ct_hif_rx_hdr_t *)buf;
 		hif_hdr->flags = (pfe_ct_hif_rx_flags_t)oal_ntohs(hif_hdr->flags);
 
 #ifdef PFE_CFG_MULTI_INSTANCE_SUPPORT
@@ -139,6 +289,10 @@ static int pfeng_hif_chnl_rx(struct pfeng_hif_chnl *chnl, int limit)
 			pfe_hif_drv_client_t *client = &chnl->ihc_client;
 
 			ihcs++;
+			skb = pfeng_bman_build_skb(chnl, buf, len);
+			if (unlikely(!skb))
+				continue;
+
 			/* IHC client callback */
 			if (!pfe_hif_drv_ihc_put_pkt(client, skb->data, skb->len, skb)) {
 
@@ -157,18 +311,34 @@ static int pfeng_hif_chnl_rx(struct pfeng_hif_chnl *chnl, int limit)
 		netif = chnl->netifs[hif_hdr->i_phy_if];
 		if (!netif) {
 			dev_err(chnl->dev, "Packet for unconfigured PhyIf %d\n", hif_hdr->i_phy_if);
-			consume_skb(skb);
+			pfeng_bman_free_buf(chnl, buf);
+			chnl->rx_skb_discard = !lifm;
 			continue;
 		}
-		netdev = netif->netdev;
-		skb->dev = netdev;
 
-		if (unlikely(hif_hdr->flags & HIF_RX_TS)) {
+		if (unlikely(!lifm)) {
+			/* Jumbo frame, assembled from page frags and not seen by XDP */
+			skb = pfeng_bman_build_skb(chnl, buf, len);
+			if (unlikely(!skb)) {
+				pfeng_netif_rxq_stats_drop(netif, chnl);
+				chnl->rx_skb_discard = true;
+				continue;
+			}
+
+			if (unlikely(hif_hdr->flags & HIF_RX_TS))
+				pfeng_hwts_skb_set_rx_ts(netif, skb);
+
+			skb_pull(skb, PFENG_TX_PKT_HEADER_SIZE);
+			chnl->rx_skb = skb;
+			chnl->rx_skb_netif = netif;
+			continue;
+		}
 
-			/* Get rx hw time stamp */
-			pfeng_hwts_skb_set_rx_ts(netif, skb);
+		if(unlikely(hif_hdr->flags & HIF_RX_ETS)) {
 
-		} else if(unlikely(hif_hdr->flags & HIF_RX_ETS)) {
+			skb = pfeng_bman_build_skb(chnl, buf, len);
+			if (unlikely(!skb))
+				continue;
 
 			/* Get tx hw time stamp */
 			pfeng_hwts_get_tx_ts(netif, skb);
@@ -178,34 +348,60 @@ static int pfeng_hif_chnl_rx(struct pfeng_hif_chnl *chnl, int limit)
 			continue;
 		}
 
-		/* Cksumming support */
-		if (likely(netdev->features & NETIF_F_RXCSUM)) {
-			/* we have only OK info, signal it */
-			skb->ip_summed = CHECKSUM_UNNECESSARY;
-			/* one level csumming support */
-			skb->csum_level = 0;
-		}
+		/* Run XDP on the frame without HIF header. Time stamped frames go to the stack */
+		xdp_prog = READ_ONCE(netif->xdp_prog);
+		if (xdp_prog && likely(!(hif_hdr->flags & HIF_RX_TS))) {
+
+			pfeng_bman_xdp_buff_init(chnl, &xdp, buf, len, &netif->xdp_rxq[chnl->idx]);
+
+			xdp_act = pfeng_xdp_run(netif, chnl, xdp_prog, &xdp);
+			if (xdp_act != PFENG_XDP_PASS) {
+				xdp_status |= xdp_act;
+				pfeng_rx_batch_count(&batch, netif, len - PFENG_TX_PKT_HEADER_SIZE);
+				goto next;
+			}
 
-		/* Pass to upper layer */
+			/* Program may have moved the frame boundaries */
+			skb = pfeng_bman_build_skb(chnl, xdp.data, xdp.data_end - xdp.data);
+			if (unlikely(!skb)) {
+				pfeng_netif_rxq_stats_drop(netif, chnl);
+				continue;
+			}
+		} else {
 
-		/* Skip HIF header */
-		skb_pull(skb, PFENG_TX_PKT_HEADER_SIZE);
+			skb = pfeng_bman_build_skb(chnl, buf, len);
+			if (unlikely(!skb)) {
+				pfeng_netif_rxq_stats_drop(netif, chnl);
+				continue;
+			}
 
-		skb->protocol = eth_type_trans(skb, netdev);
+			if (unlikely(hif_hdr->flags & HIF_RX_TS))
+				/* Get rx hw time stamp */
+				pfeng_hwts_skb_set_rx_ts(netif, skb);
 
-		if (unlikely(skb->ip_summed == CHECKSUM_NONE))
-			netif_receive_skb(skb);
-		else
-			napi_gro_receive(&chnl->napi, skb);
+			/* Skip HIF header */
+			skb_pull(skb, PFENG_TX_PKT_HEADER_SIZE);
+		}
 
-		netdev->stats.rx_packets++;
-		netdev->stats.rx_bytes += skb_headlen(skb);
+deliver:
+		pfeng_hif_chnl_rx_skb(chnl, netif, skb, &batch);
 
+next:
 		done++;
 		if(unlikely(done == limit))
 			break;
 	}
 
+	/* Flush XDP_TX and XDP_REDIRECT frames once per poll */
+	if (xdp_status)
+		pfeng_xdp_finalize(chnl, xdp_status);
+
+	pfeng_hif_chnl_rx_flush(chnl, &batch);
+
+	/* Give the consumed buffers back to HW, one doorbell per poll */
+	if (pfeng_hif_chnl_refill_rx_buffers(chnl))
+		pfe_hif_chnl_rx_dma_start(chnl->priv);
+
 #ifdef PFE_CFG_MULTI_INSTANCE_SUPPORT
 	return done + ihcs;
 #else
@@ -213,16 +409,75 @@ static int pfeng_hif_chnl_rx(struct pfeng_hif_chnl *chnl, int limit)
 #endif
 }
 
+#ifdef PFENG_CFG_DIM_SUPPORT
+static void pfeng_hif_chnl_rx_dim_set(struct pfeng_hif_chnl *chnl, struct dim_cq_moder moder)
+{
+	/* Frame count triggered coalescing is unsupported on S32G2, only the timer is tuned */
+	if (pfe_hif_chnl_set_rx_irq_coalesce(chnl->priv, 0, moder.usec * chnl->cycles_per_usec))
+		dev_warn(chnl->dev, "HIF%d RX coalescing update failed\n", chnl->idx);
+}
+
+static void pfeng_hif_chnl_rx_dim_work(struct work_struct *work)
+{
+	struct dim *dim = container_of(work, struct dim, work);
+	struct pfeng_hif_chnl *chnl = container_of(dim, struct pfeng_hif_chnl, rx_dim);
+
+	pfeng_hif_chnl_rx_dim_set(chnl, net_dim_get_rx_moderation(dim->mode, dim->profile_ix));
+	dim->state = DIM_START_MEASURE;
+}
+
+/**
+ * @brief	Turn adaptive RX interrupt moderation of HIF channel on or off
+ * @details	When turned off, the last coalescing setting stays in HW
+ * @param[in]	chnl The HIF channel
+ * @param[in]	enable True to let DIM tune the RX coalescing
+ */
+void pfeng_hif_chnl_rx_dim_enable(struct pfeng_hif_chnl *chnl, bool enable)
+{
+	if (enable == chnl->rx_dim_en)
+		return;
+
+	if (enable) {
+		chnl->rx_dim.mode = DIM_CQ_PERIOD_MODE_START_FROM_EQE;
+		chnl->rx_dim.state = DIM_START_MEASURE;
+		pfeng_hif_chnl_rx_dim_set(chnl, net_dim_get_def_rx_moderation(chnl->rx_dim.mode));
+		WRITE_ONCE(chnl->rx_dim_en, true);
+	} else {
+		WRITE_ONCE(chnl->rx_dim_en, false);
+		cancel_work_sync(&chnl->rx_dim.work);
+	}
+}
+
+/* Feed DIM with the channel counters, called once the RX NAPI completes */
+static void pfeng_hif_chnl_rx_dim_update(struct pfeng_hif_chnl *chnl)
+{
+	struct dim_sample sample = {};
+
+	dim_update_sample(++chnl->rx_dim_events, chnl->rx_dim_pkts, chnl->rx_dim_bytes, &sample);
+	net_dim(&chnl->rx_dim, sample);
+}
+#endif /* PFENG_CFG_DIM_SUPPORT */
+
 static int pfeng_hif_chnl_rx_poll(struct napi_struct *napi, int budget)
 {
 	struct pfeng_hif_chnl *chnl = container_of(napi, struct pfeng_hif_chnl, napi);
 	int done = 0;
 
 	/* Consume RX pkt(s) */
-	done = pfeng_hif_chnl_rx(chnl, budget);
+#ifdef PFENG_CFG_XSK_SUPPORT
+	if (chnl->xsk_pool)
+		done = pfeng_xsk_chnl_rx(chnl, budget);
+	else
+#endif /* PFENG_CFG_XSK_SUPPORT */
+		done = pfeng_hif_chnl_rx(chnl, budget);
 
 	if (done < budget && napi_complete_done(napi, done)) {
 
+#ifdef PFENG_CFG_DIM_SUPPORT
+		if (READ_ONCE(chnl->rx_dim_en))
+			pfeng_hif_chnl_rx_dim_update(chnl);
+#endif /* PFENG_CFG_DIM_SUPPORT */
+
 		/* Enable RX interrupt */
 		pfe_hif_chnl_rx_irq_unmask(chnl->priv);
 
@@ -233,6 +488,294 @@ static int pfeng_hif_chnl_rx_poll(struct napi_struct *napi, int budget)
 	return done;
 }
 
+/**
+ * @brief	Number of free TX ring entries required to wake stopped queue
+ * @param[in]	chnl The HIF channel
+ * @return	Wake threshold (quarter of the TX ring, at least one maximal frame)
+ */
+u16 pfeng_hif_chnl_tx_wake_thresh(struct pfeng_hif_chnl *chnl)
+{
+	/* Short rings must not wake the queue only to get it stopped again by xmit */
+	return max_t(u16, pfe_hif_chnl_get_tx_fifo_depth(chnl->priv) >> 2, MAX_SKB_FRAGS + 2);
+}
+
+/**
+ * @brief	Process HIF channel TX confirmations
+ * @param[in]	chnl The HIF channel
+ * @param[in]	limit The confirmation process limit
+ * @return	Number of confirmed frames
+ */
+static int pfeng_hif_chnl_txconf(struct pfeng_hif_chnl *chnl, int limit)
+{
+	u32 pkts[HIF_CLIENTS_MAX] = { 0 }, bytes[HIF_CLIENTS_MAX] = { 0 };
+	struct pfeng_netif *netif;
+	struct net_device *netdev;
+	u32 len;
+	int done = 0, i;
+#ifdef PFENG_CFG_XSK_SUPPORT
+	u32 xsk_frames = 0;
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
+	while (done < limit && pfe_hif_chnl_get_tx_conf(chnl->priv) == EOK) {
+
+#ifdef PFENG_CFG_XSK_SUPPORT
+		if (pfeng_hif_chnl_txconf_get_flag(chnl) == PFENG_MAP_PKT_XSK_TX)
+			xsk_frames++;
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
+#ifdef PFE_CFG_MULTI_INSTANCE_SUPPORT
+		/* Check for IHC packet first */
+		if (unlikely (pfeng_hif_chnl_txconf_get_flag(chnl) == PFENG_MAP_PKT_IHC)) {
+			pfe_hif_drv_client_t *client = &chnl->ihc_client;
+			/* IDEX confirmation must return IDEX API compatible data */
+			if (!pfe_hif_drv_ihc_put_conf(client)) {
+				/* Call IHC TX callback */
+				client->event_handler(client, client->priv, EVENT_TXDONE_IND, 0);
+			} else {
+				dev_err(chnl->dev, "TXconf IHC queuing failed.\n");
+			}
+		}
+#endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
+
+		/* Account netdev frames for BQL, IHC frames have no netdev, XDP frames no skb */
+		netdev = pfeng_hif_chnl_txconf_get_netdev(chnl, &len);
+		if (likely(netdev)) {
+			netif = netdev_priv(netdev);
+			pkts[netif->cfg->emac]++;
+			bytes[netif->cfg->emac] += len;
+		}
+
+		pfeng_hif_chnl_txconf_free_map_full(chnl);
+
+		done++;
+	}
+
+	for (i = 0; i < HIF_CLIENTS_MAX; i++) {
+		netif = chnl->netifs[i];
+		if (!pkts[i] || !netif)
+			continue;
+
+		netdev_tx_completed_queue(netdev_get_tx_queue(netif->netdev, pfeng_hif_chnl_netif_txq(chnl, netif)),
+					  pkts[i], bytes[i]);
+	}
+
+#ifdef PFENG_CFG_XSK_SUPPORT
+	if (xsk_frames)
+		xsk_tx_completed(chnl->xsk_pool, xsk_frames);
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
+	return done;
+}
+
+/**
+ * @brief	Wake TX queues served by the HIF channel
+ * @details	Every netif attached to the channel has one TX queue mapped to it.
+ *		The queue is woken once the ring has drained below the low watermark.
+ * @param[in]	chnl The HIF channel
+ */
+static void pfeng_hif_chnl_tx_wake(struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_netif *netif;
+	u16 queue;
+	int i;
+
+	/* Pairs with barrier in xmit after stopping the queue */
+	smp_mb();
+
+	if (!pfe_hif_chnl_can_accept_tx_num(chnl->priv, pfeng_hif_chnl_tx_wake_thresh(chnl)))
+		return;
+
+	for (i = 0; i < HIF_CLIENTS_MAX; i++) {
+		netif = chnl->netifs[i];
+		if (!netif)
+			continue;
+
+		queue = pfeng_hif_chnl_netif_txq(chnl, netif);
+		if (__netif_subqueue_stopped(netif->netdev, queue))
+			netif_wake_subqueue(netif->netdev, queue);
+	}
+}
+
+static int pfeng_hif_chnl_tx_poll(struct napi_struct *napi, int budget)
+{
+	struct pfeng_hif_chnl *chnl = container_of(napi, struct pfeng_hif_chnl, napi_tx);
+	int done = 0;
+
+	/* Consume TX confirmation(s) */
+	done = pfeng_hif_chnl_txconf(chnl, budget);
+
+	pfeng_hif_chnl_tx_wake(chnl);
+
+#ifdef PFENG_CFG_XSK_SUPPORT
+	/* Keep polling while XSK TX ring has more frames */
+	if (chnl->xsk_pool && !pfeng_xsk_chnl_xmit(chnl, budget))
+		done = budget;
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
+	if (done < budget && napi_complete_done(napi, done))
+		/* Enable TX interrupt */
+		pfe_hif_chnl_tx_irq_unmask(chnl->priv);
+
+	return done;
+}
+
+/**
+ * @brief	Stop traffic processing of running HIF channel
+ * @details	TX queues of attached netifs are stopped, NAPIs disabled and
+ *		frames in flight confirmed. Used to reconfigure the channel.
+ *		Has to be followed by pfeng_hif_chnl_resume().
+ * @param[in]	chnl The HIF channel
+ * @return	0 if OK, negative error code otherwise
+ */
+int pfeng_hif_chnl_quiesce(struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_netif *netif;
+	struct netdev_queue *nq;
+	int i;
+
+	if (chnl->status != PFENG_HIF_STATUS_RUNNING)
+		return 0;
+
+	for (i = 0; i < HIF_CLIENTS_MAX; i++) {
+		netif = chnl->netifs[i];
+		if (!netif)
+			continue;
+
+		nq = netdev_get_tx_queue(netif->netdev, pfeng_hif_chnl_netif_txq(chnl, netif));
+		__netif_tx_lock_bh(nq);
+		netif_tx_stop_queue(nq);
+		__netif_tx_unlock_bh(nq);
+	}
+
+	napi_disable(&chnl->napi);
+	napi_disable(&chnl->napi_tx);
+	pfe_hif_chnl_rx_irq_mask(chnl->priv);
+	pfe_hif_chnl_tx_irq_mask(chnl->priv);
+
+	/* Reclaim frames in flight */
+	for (i = 0; i < PFENG_HIF_TX_DRAIN_TRIES; i++) {
+		local_bh_disable();
+		pfeng_hif_chnl_txconf(chnl, INT_MAX);
+		local_bh_enable();
+
+		if (pfe_hif_chnl_tx_fifo_empty(chnl->priv))
+			return 0;
+
+		usleep_range(100, 200);
+	}
+
+	dev_err(chnl->dev, "HIF%d TX ring drain timed out\n", chnl->idx);
+
+	return -ETIMEDOUT;
+}
+
+/**
+ * @brief	Resume traffic processing of HIF channel stopped by pfeng_hif_chnl_quiesce()
+ * @param[in]	chnl The HIF channel
+ */
+void pfeng_hif_chnl_resume(struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_netif *netif;
+	int i;
+
+	if (chnl->status != PFENG_HIF_STATUS_RUNNING)
+		return;
+
+	napi_enable(&chnl->napi);
+	napi_enable(&chnl->napi_tx);
+	pfe_hif_chnl_rx_irq_unmask(chnl->priv);
+	pfe_hif_chnl_tx_irq_unmask(chnl->priv);
+
+	/* Ring may have been refilled meanwhile */
+	pfe_hif_chnl_rx_dma_start(chnl->priv);
+
+	for (i = 0; i < HIF_CLIENTS_MAX; i++) {
+		netif = chnl->netifs[i];
+		if (!netif || !netif_running(netif->netdev))
+			continue;
+
+		netif_tx_wake_queue(netdev_get_tx_queue(netif->netdev, pfeng_hif_chnl_netif_txq(chnl, netif)));
+	}
+}
+
+/**
+ * @brief	Change RX and TX ring length of HIF channel
+ * @details	The channel is quiesced, both rings drained, re-created with
+ *		the new length and refilled. Lengths are kept for suspend/resume.
+ * @param[in]	chnl The HIF channel
+ * @param[in]	rx_len RX ring length, power of 2
+ * @param[in]	tx_len TX ring length, power of 2
+ * @return	0 if OK, negative error code otherwise
+ */
+int pfeng_hif_chnl_set_ring_len(struct pfeng_hif_chnl *chnl, u32 rx_len, u32 tx_len)
+{
+	bool running = chnl->status == PFENG_HIF_STATUS_RUNNING;
+	int ret;
+
+	if (rx_len == pfe_hif_chnl_get_rx_fifo_depth(chnl->priv) &&
+	    tx_len == pfe_hif_chnl_get_tx_fifo_depth(chnl->priv))
+		return 0;
+
+#ifdef PFE_CFG_MULTI_INSTANCE_SUPPORT
+	/* IHC traffic can't be paused */
+	if (chnl->ihc)
+		return -EBUSY;
+#endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
+#ifdef PFENG_CFG_XSK_SUPPORT
+	/* XSK TX headers are allocated per TX ring entry */
+	if (chnl->xsk_pool)
+		return -EBUSY;
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
+	ret = pfeng_hif_chnl_quiesce(chnl);
+	if (ret)
+		goto resume;
+
+	/* Take all buffers from HW */
+	ret = pfe_hif_chnl_rx_drain(chnl->priv);
+	if (ret) {
+		dev_err(chnl->dev, "HIF%d RX ring drain failed: %d\n", chnl->idx, ret);
+		ret = -EIO;
+		goto resume;
+	}
+	pfeng_bman_rx_release_all(chnl);
+
+	/* Drain has re-enabled the DMA, rings can be replaced only when stopped */
+	pfe_hif_chnl_rx_disable(chnl->priv);
+	pfe_hif_chnl_tx_disable(chnl->priv);
+
+	ret = pfeng_bman_pool_resize(chnl, rx_len, tx_len);
+	if (ret)
+		goto refill;
+
+	ret = pfe_hif_chnl_set_ring_len(chnl->priv, rx_len, tx_len);
+	if (ret) {
+		dev_err(chnl->dev, "HIF%d ring resize failed: %d\n", chnl->idx, ret);
+		ret = -ret;
+		/* Tables only grew, so going back can't fail */
+		pfeng_bman_pool_resize(chnl, pfe_hif_chnl_get_rx_fifo_depth(chnl->priv),
+				       pfe_hif_chnl_get_tx_fifo_depth(chnl->priv));
+		goto refill;
+	}
+
+	chnl->rx_ring_len = rx_len;
+	chnl->tx_ring_len = tx_len;
+	dev_info(chnl->dev, "HIF%d ring length rx %u tx %u\n", chnl->idx, rx_len, tx_len);
+
+refill:
+	pfeng_hif_chnl_fill_rx_buffers(chnl);
+
+	if (running) {
+		pfe_hif_chnl_rx_enable(chnl->priv);
+		pfe_hif_chnl_tx_enable(chnl->priv);
+	}
+
+resume:
+	pfeng_hif_chnl_resume(chnl);
+
+	return ret;
+}
+
 static int pfeng_hif_chnl_drv_remove(struct pfeng_priv *priv, u32 idx)
 {
 	struct device *dev = &priv->pdev->dev;
@@ -248,10 +791,16 @@ static int pfeng_hif_chnl_drv_remove(struct pfeng_priv *priv, u32 idx)
 	/* Stop channel interrupt */
 	pfeng_hif_chnl_stop(chnl);
 
+#ifdef PFENG_CFG_DIM_SUPPORT
+	pfeng_hif_chnl_rx_dim_enable(chnl, false);
+#endif /* PFENG_CFG_DIM_SUPPORT */
+
 	/* Stop NAPI */
 	if (chnl->status == PFENG_HIF_STATUS_RUNNING) {
 		napi_disable(&chnl->napi);
 		netif_napi_del(&chnl->napi);
+		napi_disable(&chnl->napi_tx);
+		netif_napi_del(&chnl->napi_tx);
 	}
 	/* Prepare for startup state (in case of STR use) */
 	chnl->status = PFENG_HIF_STATUS_REQUESTED;
@@ -274,6 +823,22 @@ static int pfeng_hif_chnl_drv_remove(struct pfeng_priv *priv, u32 idx)
 	return ret;
 }
 
+/* Move the channel NAPI processing to kthreads, which can be pinned and prioritized */
+static void pfeng_hif_chnl_set_threaded(struct pfeng_hif_chnl *chnl)
+{
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,12,0)
+	int ret;
+
+	ret = dev_set_threaded(&chnl->dummy_netdev, true);
+	if (ret)
+		dev_warn(chnl->dev, "HIF%d threaded NAPI not enabled: %d\n", chnl->idx, ret);
+	else
+		dev_info(chnl->dev, "HIF%d threaded NAPI enabled\n", chnl->idx);
+#else
+	dev_warn(chnl->dev, "HIF%d threaded NAPI not supported by kernel\n", chnl->idx);
+#endif
+}
+
 static char *get_hif_chnl_mode_str(struct pfeng_hif_chnl *chnl)
 {
 	switch (chnl->cl_mode) {
@@ -306,20 +871,18 @@ static int pfeng_hif_chnl_drv_create(struct pfeng_priv *priv, u32 idx)
 	}
 	chnl->dev = dev;
 	chnl->idx = idx;
-#ifndef PFE_CFG_MULTI_INSTANCE_SUPPORT
-	if (unlikely(chnl->cl_mode == PFENG_HIF_MODE_SHARED))
-#else
-	if (unlikely((chnl->cl_mode == PFENG_HIF_MODE_SHARED) || chnl->ihc))
-#endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
-#ifdef LOCK_TX_SPINLOCK
-		spin_lock_init(&chnl->lock_tx);
-#else
-		mutex_init(&chnl->lock_tx);
-#endif
+	chnl->cycles_per_usec = DIV_ROUND_UP(clk_get_rate(priv->clk_sys), USEC_PER_SEC);
+	spin_lock_init(&chnl->lock_tx);
+#ifdef PFENG_CFG_DIM_SUPPORT
+	INIT_WORK(&chnl->rx_dim.work, pfeng_hif_chnl_rx_dim_work);
+#endif /* PFENG_CFG_DIM_SUPPORT */
 
 	/* Register HIF channel RX callback */
 	pfe_hif_chnl_set_event_cbk(chnl->priv, HIF_CHNL_EVT_RX_IRQ, &pfeng_hif_drv_chnl_rx_isr, (void *)chnl);
 
+	/* Register HIF channel TX callback */
+	pfe_hif_chnl_set_event_cbk(chnl->priv, HIF_CHNL_EVT_TX_IRQ, &pfeng_hif_drv_chnl_tx_isr, (void *)chnl);
+
 	/* Create interrupt name */
 	scnprintf(irq_name, sizeof(irq_name), "pfe-hif-%d:%s", idx, get_hif_chnl_mode_str(chnl));
 
@@ -332,6 +895,17 @@ static int pfeng_hif_chnl_drv_create(struct pfeng_priv *priv, u32 idx)
 		return ret;
 	}
 
+	/* Restore ring lengths set by ethtool, channel is not started yet */
+	if (chnl->rx_ring_len && chnl->tx_ring_len) {
+		ret = pfe_hif_chnl_set_ring_len(chnl->priv, chnl->rx_ring_len, chnl->tx_ring_len);
+		if (ret) {
+			dev_warn(dev, "HIF%d using default ring length: %d\n", idx, ret);
+			chnl->rx_ring_len = 0;
+			chnl->tx_ring_len = 0;
+			ret = 0;
+		}
+	}
+
 	/* Create bman for channel */
 	if (!chnl->bman.rx_pool) {
 		ret = pfeng_bman_pool_create(chnl);
@@ -347,10 +921,17 @@ static int pfeng_hif_chnl_drv_create(struct pfeng_priv *priv, u32 idx)
 
 	/* Create dummy netdev required for independent HIF channel support */
 	init_dummy_netdev(&chnl->dummy_netdev);
+	/* NAPI kthreads are named after the device */
+	scnprintf(chnl->dummy_netdev.name, IFNAMSIZ, "pfe-hif%d", idx);
 
 	chnl->status = PFENG_HIF_STATUS_ENABLED;
 	netif_napi_add(&chnl->dummy_netdev, &chnl->napi, pfeng_hif_chnl_rx_poll, NAPI_POLL_WEIGHT);
 	napi_enable(&chnl->napi);
+	netif_tx_napi_add(&chnl->dummy_netdev, &chnl->napi_tx, pfeng_hif_chnl_tx_poll, NAPI_POLL_WEIGHT);
+	napi_enable(&chnl->napi_tx);
+
+	if (napi_threaded & BIT(idx))
+		pfeng_hif_chnl_set_threaded(chnl);
 
 	dev_info(dev, "HIF%d enabled\n", idx);
 
@@ -11,79 +11,44 @@
 #include "pfeng.h"
 
 #ifdef PFE_CFG_PFE_MASTER
-static inline int pfeng_hwts_check_dup(struct pfeng_netif *netif,struct pfeng_ts_skb * new_entry)
+/*
+ * Reference numbers are handed out in order, so the pending requests
+ * make a ring of slots: ts_tail is the oldest one which may still wait
+ * for its time stamp. Insert, match and aging are O(1), all under
+ * ts_lock taken from xmit, RX NAPI and the aging work.
+ */
+static void pfeng_hwts_age(struct pfeng_netif *netif, ktime_t now)
 {
-	struct list_head *tmp = NULL, *curr = NULL;
-	struct pfeng_ts_skb *ts_skb = NULL;
-
-	list_for_each_safe(curr, tmp, &netif->ts_skb_list) {
-		ts_skb = list_entry(curr, struct pfeng_ts_skb, list);
-		if(new_entry->ref_num == ts_skb->ref_num) {
-			netdev_err(netif->netdev, "Duplicate ref_num %04x dropping skb\n", new_entry->ref_num);
-			return -EINVAL;
+	struct pfeng_ts_slot *slot;
+
+	while (netif->ts_tail != netif->ts_head) {
+		slot = &netif->ts_slots[netif->ts_tail & (PFENG_HWTS_SLOTS - 1)];
+		if (slot->skb) {
+			if (ktime_ms_delta(now, slot->enlisted) < PFENG_HWTS_AGE_MS)
+				break;
+
+			netdev_warn(netif->netdev, "Aging TX time stamp with ref_num %04x\n", slot->ref_num);
+			dev_kfree_skb_any(slot->skb);
+			slot->skb = NULL;
+			netif->ts_stats.tx_aged++;
 		}
+		netif->ts_tail++;
 	}
-
-	return EOK;
 }
 
-static void pfeng_hwts_work(struct work_struct *work)
+static void pfeng_hwts_age_work(struct work_struct *work)
 {
-	struct pfeng_netif *netif = container_of(work, struct pfeng_netif, ts_tx_work);
-	struct pfeng_ts_skb *ts_skb = NULL, *curr_ts_skb = NULL;
-	struct list_head *tmp = NULL, *curr = NULL;
-	struct pfeng_tx_ts tx_timestamp = { 0 };
-
-	/* First extract all new skbs that are waiting for time stamp */
-	if(!kfifo_is_empty(&netif->ts_skb_fifo)) {
-		do {
-			if (ts_skb) {
-				/* Check for duplicity juts to be sure */
-				if (pfeng_hwts_check_dup(netif, ts_skb)){
-					kfree_skb(ts_skb->skb);
-					kfree(ts_skb);
-					ts_skb = NULL;
-					continue;
-				}
-				list_add(&ts_skb->list, &netif->ts_skb_list);
-			}
-			ts_skb = kmalloc(sizeof(struct pfeng_ts_skb), GFP_KERNEL);
-		} while (0 != kfifo_get(&netif->ts_skb_fifo, ts_skb));
-
-		/* Free the unused member */
-		kfree(ts_skb);
-	}
-
-	/* Now match all time stamps that were received */
-	while (!kfifo_is_empty(&netif->ts_tx_fifo) &&
-	       (0 != kfifo_get(&netif->ts_tx_fifo, &tx_timestamp))) {
-		bool match = false;
-		list_for_each_safe(curr, tmp, &netif->ts_skb_list) {
-			curr_ts_skb = list_entry(curr, struct pfeng_ts_skb, list);
-			if (curr_ts_skb->ref_num == tx_timestamp.ref_num) {
-				match = true;
-				skb_tstamp_tx(curr_ts_skb->skb, &tx_timestamp.ts);
-				consume_skb(curr_ts_skb->skb);
-				list_del(&curr_ts_skb->list);
-				kfree(curr_ts_skb);
-				break;
-			}
-		}
+	struct pfeng_netif *netif = container_of(to_delayed_work(work), struct pfeng_netif, ts_age_work);
+	bool pending;
 
-		if (false == match)
-			netdev_err(netif->netdev, "Dropping unknown TX time stamp with ref_num %04x\n", tx_timestamp.ref_num);
-	}
+	spin_lock_bh(&netif->ts_lock);
+	pfeng_hwts_age(netif, ktime_get());
+	pending = netif->ts_tail != netif->ts_head;
+	spin_unlock_bh(&netif->ts_lock);
 
-	/* Here do aging (time stamp has to be available in less than 1ms but we will wait for 5ms) */
-	list_for_each_safe(curr, tmp, &netif->ts_skb_list) {
-		curr_ts_skb = list_entry(curr, struct pfeng_ts_skb, list);
-		if (time_after(jiffies, curr_ts_skb->jif_enlisted + usecs_to_jiffies(5000U))) {
-			netdev_warn(netif->netdev, "Aging TX time stamp with ref_num %04x\n", curr_ts_skb->ref_num);
-			kfree_skb(curr_ts_skb->skb);
-			list_del(&curr_ts_skb->list);
-			kfree(curr_ts_skb);
-		}
-	}
+	/* Release skbs of lost time stamps also when no more frames are sent */
+	if (pending)
+		schedule_delayed_work(&netif->ts_age_work, msecs_to_jiffies(PFENG_HWTS_AGE_MS));
 }
 
 /* Store HW time stamp to skb */
@@ -102,42 +67,101 @@ void pfeng_hwts_skb_set_rx_ts(struct pfeng_netif *netif, struct sk_buff *skb)
 /* Store reference to tx skb that should be time stamped */
 int pfeng_hwts_store_tx_ref(struct pfeng_netif *netif, struct sk_buff *skb)
 {
-	int ret = 1;
-	struct pfeng_ts_skb ts_skb_entry;
+	struct pfeng_ts_slot *slot;
+	ktime_t now = ktime_get();
+	u16 ref_num;
+
+	spin_lock_bh(&netif->ts_lock);
+
+	if (netif->ts_head - netif->ts_tail >= PFENG_HWTS_SLOTS) {
+		pfeng_hwts_age(netif, now);
+		if (netif->ts_head - netif->ts_tail >= PFENG_HWTS_SLOTS) {
+			netif->ts_stats.tx_skipped++;
+			spin_unlock_bh(&netif->ts_lock);
+			return -ENOMEM;
+		}
+	}
 
-	/* Store info for future timestamp */
-	ts_skb_entry.skb = skb;
-	ts_skb_entry.jif_enlisted = jiffies;
-	ts_skb_entry.ref_num = netif->ts_ref_num++ & 0x0FFFU;
+	/* Increment reference counter (required to free the skb correctly)*/
+	slot = &netif->ts_slots[netif->ts_head & (PFENG_HWTS_SLOTS - 1)];
+	ref_num = netif->ts_head & PFENG_HWTS_REF_MASK;
+	slot->skb = skb_get(skb);
+	slot->enlisted = now;
+	slot->ref_num = ref_num;
+	netif->ts_head++;
+	netif->ts_stats.tx_requested++;
 
-	/* Send data to worker */
-	ret = kfifo_put(&netif->ts_skb_fifo, ts_skb_entry);
-	if(0 == ret)
-		return -ENOMEM;
+	spin_unlock_bh(&netif->ts_lock);
 
-	/* Increment reference counter (required to free the skb correctly)*/
-	(void)skb_get(skb);
-	schedule_work(&netif->ts_tx_work);
+	/* No-op while aging is already scheduled */
+	schedule_delayed_work(&netif->ts_age_work, msecs_to_jiffies(PFENG_HWTS_AGE_MS));
+
+	return ref_num;
+}
 
-	return ts_skb_entry.ref_num;
+/* Give back the slot of a frame which did not make it to the HIF ring */
+void pfeng_hwts_release_tx_ref(struct pfeng_netif *netif, struct sk_buff *skb, u16 ref_num)
+{
+	struct pfeng_ts_slot *slot;
+	struct sk_buff *ts_skb = NULL;
+
+	spin_lock_bh(&netif->ts_lock);
+	slot = &netif->ts_slots[ref_num & (PFENG_HWTS_SLOTS - 1)];
+	if (likely(slot->skb == skb && slot->ref_num == ref_num)) {
+		ts_skb = slot->skb;
+		slot->skb = NULL;
+		netif->ts_stats.tx_requested--;
+	}
+	spin_unlock_bh(&netif->ts_lock);
+
+	/* Requeued frame asks for a new slot on the next attempt */
+	skb_shinfo(skb)->tx_flags &= ~SKBTX_IN_PROGRESS;
+	if (ts_skb)
+		dev_kfree_skb_any(ts_skb);
 }
 
-/* Store time stamp that should be matched with skb */
+/* Match time stamp report with the skb and pass the time stamp to the socket */
 void pfeng_hwts_get_tx_ts(struct pfeng_netif *netif, struct sk_buff *skb)
 {
 	pfe_ct_ets_report_t *etsr = (pfe_ct_ets_report_t *)((addr_t)skb->data + sizeof(pfe_ct_hif_rx_hdr_t));
-	struct pfeng_tx_ts tx_timestamp;
-	int ret = 1;
+	struct skb_shared_hwtstamps hwts = { 0 };
+	struct sk_buff *ts_skb = NULL;
+	struct pfeng_ts_slot *slot;
+	ktime_t arrived = ktime_get();
+	u16 ref_num;
+	u64 lat;
+
+	hwts.hwtstamp = ns_to_ktime(etsr->ts_sec * 1000000000ULL + etsr->ts_nsec);
+	ref_num = ntohs(etsr->ref_num) & PFENG_HWTS_REF_MASK;
+
+	if (unlikely(!netif->ts_slots))
+		return;
+
+	spin_lock(&netif->ts_lock);
+	slot = &netif->ts_slots[ref_num & (PFENG_HWTS_SLOTS - 1)];
+	if (likely(slot->skb && slot->ref_num == ref_num)) {
+		ts_skb = slot->skb;
+		slot->skb = NULL;
+	} else {
+		netif->ts_stats.tx_unknown++;
+	}
+	spin_unlock(&netif->ts_lock);
 
-	tx_timestamp.ts.hwtstamp = ns_to_ktime(etsr->ts_sec * 1000000000ULL + etsr->ts_nsec);
-	tx_timestamp.ref_num = ntohs(etsr->ref_num) & 0x0FFFU;
+	if (unlikely(!ts_skb)) {
+		netdev_err(netif->netdev, "Dropping unknown TX time stamp with ref_num %04x\n", ref_num);
+		return;
+	}
 
-	/* Send time stamp to worker */
-	ret = kfifo_put(&netif->ts_tx_fifo, tx_timestamp);
-	schedule_work(&netif->ts_tx_work);
+	skb_tstamp_tx(ts_skb, &hwts);
+	consume_skb(ts_skb);
 
-	if(0 == ret)
-		netdev_err(netif->netdev, "No more memory. Time stamp dropped.\n");
+	lat = ktime_to_ns(ktime_sub(ktime_get(), arrived));
+	spin_lock(&netif->ts_lock);
+	netif->ts_stats.tx_matched++;
+	netif->ts_stats.tx_lat_sum_ns += lat;
+	if (lat > netif->ts_stats.tx_lat_max_ns)
+		netif->ts_stats.tx_lat_max_ns = lat;
+	spin_unlock(&netif->ts_lock);
 }
 #else /* PFE_CFG_PFE_MASTER */
 void pfeng_hwts_skb_set_rx_ts(struct pfeng_netif *netif, struct sk_buff *skb)
@@ -155,11 +179,16 @@ int pfeng_hwts_store_tx_ref(struct pfeng_netif *netif, struct sk_buff *skb)
 	return -ENOMEM;
 }
 
+void pfeng_hwts_release_tx_ref(struct pfeng_netif *netif, struct sk_buff *skb, u16 ref_num)
+{
+	/* NOP */
+}
+
 void pfeng_hwts_get_tx_ts(struct pfeng_netif *netif, struct sk_buff *skb)
 {
 	/* NOP */
 }
-static void pfeng_hwts_work(struct work_struct *work)
+static void pfeng_hwts_age_work(struct work_struct *work)
 {
 	/* NOP */
 }
@@ -274,22 +303,42 @@ int pfeng_hwts_ethtool(struct pfeng_netif *netif, struct ethtool_ts_info *info)
 	return 0;
 }
 
+/* Counters in order of struct pfeng_hwts_stats, the latency sum is reported as average */
+void pfeng_hwts_get_stats(struct pfeng_netif *netif, u64 *data)
+{
+	struct pfeng_hwts_stats stats;
+
+	spin_lock_bh(&netif->ts_lock);
+	stats = netif->ts_stats;
+	spin_unlock_bh(&netif->ts_lock);
+
+	if (stats.tx_matched)
+		stats.tx_lat_sum_ns = div64_u64(stats.tx_lat_sum_ns, stats.tx_matched);
+	memcpy(data, &stats, sizeof(stats));
+}
+
 int pfeng_hwts_init(struct pfeng_netif *netif)
 {
-#ifdef PFE_CFG_PFE_MASTER
+	/* Called again on resume, keep the slots and counters */
+	if (netif->ts_work_on)
+		goto out;
 
-	if (kfifo_alloc(&netif->ts_skb_fifo, 32, GFP_KERNEL))
-		return -ENOMEM;
+	spin_lock_init(&netif->ts_lock);
+	netif->ts_head = 0;
+	netif->ts_tail = 0;
+	memset(&netif->ts_stats, 0, sizeof(netif->ts_stats));
 
-	if (kfifo_alloc(&netif->ts_tx_fifo, 32, GFP_KERNEL))
+#ifdef PFE_CFG_PFE_MASTER
+	netif->ts_slots = kcalloc(PFENG_HWTS_SLOTS, sizeof(*netif->ts_slots), GFP_KERNEL);
+	if (!netif->ts_slots)
 		return -ENOMEM;
 #endif /* PFE_CFG_PFE_MASTER */
 
 	/* Initialize for master and slave to have easier cleanup */
-	INIT_LIST_HEAD(&netif->ts_skb_list);
-	INIT_WORK(&netif->ts_tx_work, pfeng_hwts_work);
+	INIT_DELAYED_WORK(&netif->ts_age_work, pfeng_hwts_age_work);
 	netif->ts_work_on = true;
 
+out:
 	/* Store default config */
 	netif->tshw_cfg.flags = 0;
 	netif->tshw_cfg.rx_filter = HWTSTAMP_FILTER_NONE;
@@ -300,14 +349,18 @@ int pfeng_hwts_init(struct pfeng_netif *netif)
 
 void pfeng_hwts_release(struct pfeng_netif *netif)
 {
+	u32 i;
+
 	if (netif->ts_work_on) {
-		cancel_work_sync(&netif->ts_tx_work);
+		cancel_delayed_work_sync(&netif->ts_age_work);
 		netif->ts_work_on = false;
 	}
 
-	if (kfifo_initialized(&netif->ts_skb_fifo))
-		kfifo_free(&netif->ts_skb_fifo);
-
-	if (kfifo_initialized(&netif->ts_tx_fifo))
-		kfifo_free(&netif->ts_tx_fifo);
+	if (netif->ts_slots) {
+		for (i = 0; i < PFENG_HWTS_SLOTS; i++)
+			if (netif->ts_slots[i].skb)
+				kfree_skb(netif->ts_slots[i].skb);
+		kfree(netif->ts_slots);
+		netif->ts_slots = NULL;
+	}
 }
@@ -43,7 +43,9 @@ static int pfeng_netif_logif_open(struct net_device *netdev)
 
 	/* Configure real RX and TX queues */
 	netif_set_real_num_rx_queues(netdev, netif->cfg->hifs);
-	netif_set_real_num_tx_queues(netdev, 1);
+	netif_set_real_num_tx_queues(netdev, netif->cfg->hifs);
+	for (i = 0; i < netif->cfg->hifs; i++)
+		netdev_tx_reset_queue(netdev_get_tx_queue(netdev, i));
 
 	/* start HIF channel(s) */
 	pfeng_netif_for_each_chnl(netif, i, chnl) {
@@ -87,153 +89,337 @@ err_mac_ena:
 	return ret;
 }
 
-/* Map TX traffic to HIF channel. Currently is used only first HIF channel for TX */
-static struct pfeng_hif_chnl *pfeng_netif_map_tx_channel(struct pfeng_netif *netif, struct sk_buff *skb)
+/* Build TX queue to HIF channel map. Queue N is served by N-th HIF channel in hifmap */
+static void pfeng_netif_map_tx_queues(struct pfeng_netif *netif)
 {
-	u32 id = ffs(netif->cfg->hifmap);
+	u32 i, q = 0;
 
-	if (id < 1)
+	for (i = 0; i < PFENG_PFE_HIF_CHANNELS; i++) {
+		if (netif->cfg->hifmap & (1 << i))
+			netif->tx_chnl[q++] = i;
+	}
+}
+
+/* Map TX queue to HIF channel */
+static struct pfeng_hif_chnl *pfeng_netif_map_tx_channel(struct pfeng_netif *netif, u16 queue)
+{
+	if (unlikely(queue >= netif->cfg->hifs))
 		return NULL;
 
-	//TODO: id = skb_get_queue_mapping(skb);
+	return &netif->priv->hif_chnl[netif->tx_chnl[queue]];
+}
 
-	return &netif->priv->hif_chnl[id - 1];
+static void pfeng_netif_txq_stats_add(struct pfeng_netif *netif, u16 queue, u32 len, bool copied)
+{
+	struct pfeng_txq_stats *stats = &netif->txq_stats[queue];
+
+	u64_stats_update_begin(&stats->syncp);
+	stats->packets++;
+	stats->bytes += len;
+	if (copied)
+		stats->copybreak++;
+	u64_stats_update_end(&stats->syncp);
 }
 
-static int pfeng_netif_logif_txack(struct pfeng_hif_chnl *chnl, int limit)
+/*
+ * TX drop reasons. Frames of STOPPED, CHNL_DOWN and OVERLIMITED are returned
+ * to the stack with NETDEV_TX_BUSY and requeued, only the freed ones are dropped.
+ */
+enum pfeng_txq_drop {
+	PFENG_TXQ_DROP,
+	PFENG_TXQ_DROP_STOPPED,
+	PFENG_TXQ_DROP_CHNL_DOWN,
+	PFENG_TXQ_DROP_OVERLIMITED,
+	PFENG_TXQ_DROP_DMA_MAP,
+};
+
+static void pfeng_netif_txq_stats_drop(struct pfeng_netif *netif, u16 queue, enum pfeng_txq_drop reason)
 {
-	unsigned int done = 0;
+	struct pfeng_txq_stats *stats = &netif->txq_stats[queue];
 
-	while(pfe_hif_chnl_get_tx_conf(chnl->priv) == EOK) {
+	u64_stats_update_begin(&stats->syncp);
+	switch (reason) {
+	case PFENG_TXQ_DROP_STOPPED:
+		stats->stopped++;
+		break;
+	case PFENG_TXQ_DROP_CHNL_DOWN:
+		stats->chnl_down++;
+		break;
+	case PFENG_TXQ_DROP_OVERLIMITED:
+		stats->overlimited++;
+		break;
+	case PFENG_TXQ_DROP_DMA_MAP:
+		stats->dma_map_failed++;
+		stats->dropped++;
+		break;
+	default:
+		stats->dropped++;
+		break;
+	}
+	u64_stats_update_end(&stats->syncp);
+}
 
-#ifdef PFE_CFG_MULTI_INSTANCE_SUPPORT
-		/* Check for IHC packet first */
-		if (unlikely (pfeng_hif_chnl_txconf_get_flag(chnl) == PFENG_MAP_PKT_IHC)) {
-			pfe_hif_drv_client_t *client = &chnl->ihc_client;
-			/* IDEX confirmation must return IDEX API compatible data */
-			if (!pfe_hif_drv_ihc_put_conf(client)) {
-				/* Call IHC TX callback */
-				client->event_handler(client, client->priv, EVENT_TXDONE_IND, 0);
-			} else {
-				dev_err(chnl->dev, "TXconf IHC queuing failed.\n");
-			}
-		}
-#endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
+/**
+ * @brief	Fill HIF TX header common to all frames of the netif
+ * @param[in]	netif Net interface instance
+ * @param[in]	chnl The HIF channel the frame is sent through
+ * @param[out]	tx_hdr The TX header
+ */
+void pfeng_netif_tx_hdr_init(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, pfe_ct_hif_tx_hdr_t *tx_hdr)
+{
+	memset(tx_hdr, 0, sizeof(*tx_hdr));
+	tx_hdr->chid = chnl->idx;
+
+#ifdef PFE_CFG_HIF_PRIO_CTRL
+	/* Firmware will assign queue/priority */
+	tx_hdr->queue = 255;
+#else
+	tx_hdr->queue = 0;
+#endif /* PFE_CFG_HIF_PRIO_CTRL */
+
+#ifdef PFE_CFG_ROUTE_HIF_TRAFFIC
+	/* Tag the frame with ID of target physical interface */
+	tx_hdr->cookie = oal_htonl(netif->cfg->emac);
+#else
+	tx_hdr->flags |= HIF_TX_INJECT;
+	tx_hdr->e_phy_ifs = oal_htonl(1U << netif->cfg->emac);
+#endif /* PFE_CFG_ROUTE_HIF_TRAFFIC */
+}
+
+/* Stop the queue, unless TX confirmation has made enough room meanwhile */
+static void pfeng_netif_txq_stop(struct net_device *netdev, struct pfeng_hif_chnl *chnl, u16 queue)
+{
+	netif_stop_subqueue(netdev, queue);
+	/* Pairs with barrier in TX confirmation NAPI */
+	smp_mb();
+	if (pfe_hif_chnl_can_accept_tx_num(chnl->priv, pfeng_hif_chnl_tx_wake_thresh(chnl)))
+		netif_start_subqueue(netdev, queue);
+}
+
+/* Buffer of a frame prepared for HIF TX ring */
+struct pfeng_netif_tx_buf {
+	void				*va;
+	dma_addr_t			des;
+	u32				len;
+};
+
+static void pfeng_netif_logif_unmap_bufs(struct device *dev, struct pfeng_netif_tx_buf *bufs, int nbufs)
+{
+	int i;
+
+	/* First buffer is always the linear part */
+	for (i = nbufs - 1; i > 0; i--)
+		dma_unmap_page(dev, bufs[i].des, bufs[i].len, DMA_TO_DEVICE);
+	if (nbufs)
+		dma_unmap_single(dev, bufs[0].des, bufs[0].len, DMA_TO_DEVICE);
+}
 
-		pfeng_hif_chnl_txconf_free_map_full(chnl);
+/**
+ * @brief	DMA map the frame buffers
+ * @details	Mapping is done outside of the shared channel lock to keep
+ *		the critical section limited to the ring enqueue.
+ * @param[in]	netif Net interface instance
+ * @param[in]	skb The frame
+ * @param[out]	bufs Array of mapped buffers (MAX_SKB_FRAGS + 1)
+ * @return	Number of mapped buffers, negative error code otherwise
+ */
+static int pfeng_netif_logif_map_bufs(struct pfeng_netif *netif, struct sk_buff *skb, struct pfeng_netif_tx_buf *bufs)
+{
+	u32 nfrags = skb_shinfo(skb)->nr_frags;
+	int f, nbufs = 0;
+
+	/* Linear part */
+	bufs[0].va = skb->data;
+	bufs[0].len = skb_headlen(skb);
+	bufs[0].des = dma_map_single(netif->dev, skb->data, bufs[0].len, DMA_TO_DEVICE);
+	if (unlikely(dma_mapping_error(netif->dev, bufs[0].des))) {
+		net_err_ratelimited("%s: Frame mapping failed. Packet dropped.\n", netif->netdev->name);
+		return -ENOMEM;
+	}
+	nbufs++;
 
-		done++;
+	/* Frags */
+	for (f = 0; f < nfrags; f++) {
+		skb_frag_t *frag = &skb_shinfo(skb)->frags[f];
+
+		if (!skb_frag_size(frag))
+			continue;
+
+		bufs[nbufs].va = frag;
+		bufs[nbufs].len = skb_frag_size(frag);
+		bufs[nbufs].des = skb_frag_dma_map(netif->dev, frag, 0, bufs[nbufs].len, DMA_TO_DEVICE);
+		if (unlikely(dma_mapping_error(netif->dev, bufs[nbufs].des))) {
+			net_err_ratelimited("%s: Fragment mapping failed. Packet dropped.\n", netif->netdev->name);
+			pfeng_netif_logif_unmap_bufs(netif->dev, bufs, nbufs);
+			return -ENOMEM;
+		}
+		nbufs++;
 	}
-	return done;
+
+	return nbufs;
 }
 
-static void pfeng_netif_tx_conf(struct work_struct *work)
+/**
+ * @brief	Send small frame by copy
+ * @details	Frame is copied behind the HIF TX header into the bounce buffer
+ *		of the ring entry, which saves DMA mapping of the skb. The skb is
+ *		released right away.
+ * @param[in]	netif Net interface instance
+ * @param[in]	chnl The HIF channel
+ * @param[in]	skb The frame, not longer than PFENG_TX_COPYBREAK_MAX
+ * @param[in]	queue The TX queue
+ * @param[in]	xmit_more More frames are coming
+ * @return	NETDEV_TX_OK or NETDEV_TX_BUSY with the skb untouched
+ */
+static netdev_tx_t pfeng_netif_logif_xmit_copy(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl,
+					       struct sk_buff *skb, u16 queue, bool xmit_more)
 {
-	struct pfeng_netif *netif = container_of(work, struct pfeng_netif, tx_conf_work);
-	struct pfeng_hif_chnl *chnl;
-	int ring_len;
+	struct net_device *netdev = netif->netdev;
+	struct netdev_queue *txq = netdev_get_tx_queue(netdev, queue);
+	enum pfeng_txq_drop reason = PFENG_TXQ_DROP_STOPPED;
+	u32 len = PFENG_TX_PKT_HEADER_SIZE + skb->len;
+	pfe_ct_hif_tx_hdr_t *tx_hdr;
+	bool shared, kick;
+	dma_addr_t des;
+	errno_t ret;
 
-	/* TODO: replace this with Tx NAPI! */
-	chnl = pfeng_netif_map_tx_channel(netif, NULL);
-	pfeng_netif_logif_txack(chnl, 0 /* no NAPI */);
-	ring_len = pfe_hif_chnl_get_tx_fifo_depth(chnl->priv);
+	/* Bounce buffer is selected by the ring write position */
+	shared = pfeng_hif_chnl_tx_shared(chnl);
+	if (unlikely(shared))
+		spin_lock(&chnl->lock_tx);
 
-	if (pfe_hif_chnl_can_accept_tx_num(chnl->priv, ring_len >> 1)) {
-		/* only one queue per netdev used at this point */
-		netif_wake_subqueue(netif->netdev, 0);
-	} else {
-		schedule_work(&netif->tx_conf_work);
+#ifdef PFE_CFG_HIF_TX_FIFO_FIX
+	if (unlikely(FALSE == pfe_hif_chnl_can_accept_tx_data(chnl->priv, len))) {
+		net_err_ratelimited("%s: Packet overlimited.\n", netdev->name);
+		reason = PFENG_TXQ_DROP_OVERLIMITED;
+		goto busy;
 	}
+#endif /* PFE_CFG_HIF_TX_FIFO_FIX */
+
+	/* Other producers may have consumed the space meanwhile */
+	if (unlikely(shared && !pfe_hif_chnl_can_accept_tx_num(chnl->priv, 1)))
+		goto busy;
+
+	tx_hdr = pfeng_hif_chnl_txconf_copybreak_buf(chnl, &des);
+	pfeng_netif_tx_hdr_init(netif, chnl, tx_hdr);
+	if (likely(netdev->features & NETIF_F_IP_CSUM))
+		tx_hdr->flags |= HIF_TX_IP_CSUM | HIF_TX_TCP_CSUM | HIF_TX_UDP_CSUM;
+
+	/* Linear part and frags */
+	skb_copy_bits(skb, 0, tx_hdr + 1, skb->len);
+
+	pfeng_hif_chnl_txconf_put_map_copy(chnl, tx_hdr, des, len, netdev);
+
+	/* Report to BQL before HW may see the frame. Trigger DMA at the end of burst only */
+	kick = __netdev_tx_sent_queue(txq, len, xmit_more);
+
+	ret = pfe_hif_chnl_tx_enqueue(chnl->priv, (void *)des, tx_hdr, len, true);
+	if (unlikely(EOK != ret)) {
+		net_err_ratelimited("%s: HIF channel tx failed. Packet dropped. Error %d\n", netdev->name, ret);
+		pfeng_hif_chnl_txconf_unroll_map_copy(chnl);
+		if (unlikely(shared))
+			spin_unlock(&chnl->lock_tx);
+		/* Frame never reached the ring, take it back from BQL */
+		netdev_tx_completed_queue(txq, 1, len);
+		pfe_hif_chnl_tx_dma_start(chnl->priv);
+		pfeng_netif_txq_stats_drop(netif, queue, PFENG_TXQ_DROP);
+		dev_kfree_skb_any(skb);
+		return NETDEV_TX_OK;
+	}
+
+	if (unlikely(shared))
+		spin_unlock(&chnl->lock_tx);
+
+	pfeng_netif_txq_stats_add(netif, queue, len, true);
+
+	/* Software tx time stamp, the skb is not needed anymore */
+	skb_tx_timestamp(skb);
+	dev_consume_skb_any(skb);
+
+	/* Stop the queue early if the next frame may not fit */
+	if (unlikely(!pfe_hif_chnl_can_accept_tx_num(chnl->priv, MAX_SKB_FRAGS + 2))) {
+		pfeng_netif_txq_stop(netdev, chnl, queue);
+		kick = true;
+	}
+
+	if (kick)
+		pfe_hif_chnl_tx_dma_start(chnl->priv);
+
+	return NETDEV_TX_OK;
+
+busy:
+	if (unlikely(shared))
+		spin_unlock(&chnl->lock_tx);
+	pfeng_netif_txq_stop(netdev, chnl, queue);
+	/* Flush frames deferred by xmit_more */
+	pfe_hif_chnl_tx_dma_start(chnl->priv);
+	pfeng_netif_txq_stats_drop(netif, queue, reason);
+	return NETDEV_TX_BUSY;
 }
 
 static netdev_tx_t pfeng_netif_logif_xmit(struct sk_buff *skb, struct net_device *netdev)
 {
 	struct pfeng_netif *netif = netdev_priv(netdev);
+	struct pfeng_netif_tx_buf bufs[MAX_SKB_FRAGS + 1];
+	pfe_hif_ring_buf_t hw_bufs[MAX_SKB_FRAGS + 2];
 	errno_t ret = -EINVAL;
-	unsigned int plen;
-	u32 nfrags = skb_shinfo(skb)->nr_frags;
-	dma_addr_t des = 0;
-	int f, ref_num = 0, refid = -1;
+	unsigned int len;
+	int i, nbufs, nhw = 0, ref_num = 0, refid;
 	struct pfeng_hif_chnl *chnl;
-	pfe_ct_hif_tx_hdr_t *tx_hdr;
+	pfe_ct_hif_tx_hdr_t *tx_hdr, hdr_tmp, *hdr_va;
+	dma_addr_t hdr_des;
+	u16 queue = skb_get_queue_mapping(skb);
+	struct netdev_queue *txq = netdev_get_tx_queue(netdev, queue);
+	enum pfeng_txq_drop reason = PFENG_TXQ_DROP;
+	bool shared, kick, hdr_bd, ts_ref = false;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,2,0)
+	bool xmit_more = netdev_xmit_more();
+#else
+	bool xmit_more = skb->xmit_more;
+#endif
 
 	/* Get mapped HIF channel */
-	chnl = pfeng_netif_map_tx_channel(netif, skb);
+	chnl = pfeng_netif_map_tx_channel(netif, queue);
 	if (unlikely (!chnl)) {
 		net_err_ratelimited("%s: Packet dropped. Map channel failed\n", netdev->name);
-		netdev->stats.tx_dropped++;
+		atomic64_inc(&netif->tx_map_chnl_failed);
 		return NETDEV_TX_BUSY;
 	}
 	if (unlikely (chnl->status != PFENG_HIF_STATUS_RUNNING)) {
 		net_err_ratelimited("%s: Packet dropped. Channel is not in running state\n", netdev->name);
-		netdev->stats.tx_dropped++;
+		pfeng_netif_txq_stats_drop(netif, queue, PFENG_TXQ_DROP_CHNL_DOWN);
 		return NETDEV_TX_BUSY;
 	}
 
-	/* Protect shared HIF channel resource */
-#ifndef PFE_CFG_MULTI_INSTANCE_SUPPORT
-	if (unlikely(chnl->cl_mode == PFENG_HIF_MODE_SHARED))
-#else
-	if (unlikely((chnl->cl_mode == PFENG_HIF_MODE_SHARED) || chnl->ihc))
-#endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
-#ifdef LOCK_TX_SPINLOCK
-		spin_lock(&chnl->lock_tx);
-#else
-		mutex_lock(&chnl->lock_tx);
-#endif
-
-#ifdef PFE_CFG_HIF_TX_FIFO_FIX
-	if (unlikely(FALSE == pfe_hif_chnl_can_accept_tx_data(chnl->priv, skb_pagelen(skb) + PFENG_TX_PKT_HEADER_SIZE))) {
-		net_err_ratelimited("%s: Packet overlimited.\n", netdev->name);
-		goto busy_drop;
-	}
-#endif /* PFE_CFG_HIF_TX_FIFO_FIX */
-
-	/* Cleanup Tx HIF channel ring(s) first */
-	pfeng_netif_logif_txack(chnl, 0 /* no NAPI */);
-
-	/* Check for ring space */
-	if (unlikely(!pfe_hif_chnl_can_accept_tx_num(chnl->priv, nfrags + 1))) {
-		netif_stop_subqueue(netdev, skb->queue_mapping);
-		/* TODO: replace this with Tx NAPI! */
-		schedule_work(&netif->tx_conf_work);
-		goto busy_drop;
+	/* Check for ring space, including optional header BD. Queue is woken by TX confirmation NAPI */
+	if (unlikely(!pfe_hif_chnl_can_accept_tx_num(chnl->priv, skb_shinfo(skb)->nr_frags + 2))) {
+		reason = PFENG_TXQ_DROP_STOPPED;
+		goto busy_stop;
 	}
 
-	/* Prepare headroom for TX PFE packet header */
-	if (skb_headroom(skb) < PFENG_TX_PKT_HEADER_SIZE) {
-		struct sk_buff *skb_new;
+	/* Small frames go by copy, time stamped ones need the skb kept */
+	if (skb->len <= READ_ONCE(netif->tx_copybreak) &&
+	    likely(!(skb_shinfo(skb)->tx_flags & SKBTX_HW_TSTAMP)))
+		return pfeng_netif_logif_xmit_copy(netif, chnl, skb, queue, xmit_more);
 
-		skb_new = skb_realloc_headroom(skb, PFENG_TX_PKT_HEADER_SIZE);
-		if (!skb_new)
-			goto busy_drop;
-		kfree_skb(skb);
-		skb = skb_new;
+	/*
+	 * TX header goes into headroom reserved by needed_headroom. Frames without
+	 * it or with shared header data get the header in own BD sent from the
+	 * bounce buffer of the ring entry, so the frame is never copied.
+	 */
+	hdr_bd = unlikely(skb_headroom(skb) < PFENG_TX_PKT_HEADER_SIZE || skb_header_cloned(skb));
+	if (likely(!hdr_bd)) {
+		skb_push(skb, PFENG_TX_PKT_HEADER_SIZE);
+		tx_hdr = (pfe_ct_hif_tx_hdr_t *)skb->data;
+	} else {
+		tx_hdr = &hdr_tmp;
 	}
 
-	skb_push(skb, PFENG_TX_PKT_HEADER_SIZE);
-
-	plen = skb_headlen(skb);
+	/* skb may be released by TX confirmation once handed over to HIF */
+	len = skb->len;
 
 	/* Set TX header */
-	tx_hdr = (pfe_ct_hif_tx_hdr_t *)skb->data;
-	memset(tx_hdr, 0, sizeof(*tx_hdr));
-	tx_hdr->chid = chnl->idx;
-
-#ifdef PFE_CFG_HIF_PRIO_CTRL
-	/* Firmware will assign queue/priority */
-	tx_hdr->queue = 255;
-#else
-	tx_hdr->queue = 0;
-#endif /* PFE_CFG_HIF_PRIO_CTRL */
-
-#ifdef PFE_CFG_ROUTE_HIF_TRAFFIC
-	/* Tag the frame with ID of target physical interface */
-	tx_hdr->cookie = oal_htonl(netif->cfg->emac);
-#else
-	tx_hdr->flags |= HIF_TX_INJECT;
-	tx_hdr->e_phy_ifs = oal_htonl(1U << netif->cfg->emac);
-#endif /* PFE_CFG_ROUTE_HIF_TRAFFIC */
+	pfeng_netif_tx_hdr_init(netif, chnl, tx_hdr);
 
 	if (likely(netdev->features & NETIF_F_IP_CSUM))
 		tx_hdr->flags |= HIF_TX_IP_CSUM | HIF_TX_TCP_CSUM | HIF_TX_UDP_CSUM;
@@ -251,89 +437,118 @@ static netdev_tx_t pfeng_netif_logif_xmit(struct sk_buff *skb, struct net_device
 			/* Tell HW to make timestamp  with our ref_num */
 			tx_hdr->flags |= HIF_TX_ETS;
 			tx_hdr->refnum = htons(ref_num);
+			ts_ref = true;
 		}
-		/* In error case no warning is necessary, it will come later from the worker. */
+		/* Frame goes without time stamp when all slots are pending, see hwts_tx_skipped */
 	}
 
-	/* Fill linear part of packet */
-	des = dma_map_single(netif->dev, skb->data, plen, DMA_TO_DEVICE);
-	if (unlikely(dma_mapping_error(netif->dev, des))) {
-		net_err_ratelimited("%s: Frame mapping failed. Packet dropped.\n", netdev->name);
-		goto busy_drop;
+	/* Map linear part and frags */
+	nbufs = pfeng_netif_logif_map_bufs(netif, skb, bufs);
+	if (unlikely(nbufs < 0)) {
+		reason = PFENG_TXQ_DROP_DMA_MAP;
+		goto drop;
 	}
-	refid = pfeng_hif_chnl_txconf_put_map_frag(chnl, skb->data, des, plen, skb, PFENG_MAP_PKT_NORMAL);
-	/* Increment to be able to pass number 0 */
-	refid++;
 
 	/* Software tx time stamp */
 	skb_tx_timestamp(skb);
 
-	/* Put linear part */
-	ret = pfe_hif_chnl_tx(chnl->priv, (void *)des, skb->data, plen, !nfrags);
-	if (unlikely(EOK != ret)) {
-		net_err_ratelimited("%s: HIF channel tx failed. Packet dropped. Error %d\n", netdev->name, ret);
-		pfeng_hif_chnl_txconf_unroll_map_full(chnl, refid - 1, 0);
-		goto busy_drop;
-	}
-
-	/* Process frags */
-	for (f = 0; f < nfrags; f++) {
-		skb_frag_t *frag = &skb_shinfo(skb)->frags[f];
+	/* Protect shared HIF channel resource, only the ring enqueue is serialized */
+	shared = pfeng_hif_chnl_tx_shared(chnl);
+	if (unlikely(shared))
+		spin_lock(&chnl->lock_tx);
 
-		plen = skb_frag_size(frag);
-		if (!plen) {
-			nfrags--;
-			continue;
-		}
+#ifdef PFE_CFG_HIF_TX_FIFO_FIX
+	if (unlikely(FALSE == pfe_hif_chnl_can_accept_tx_data(chnl->priv, hdr_bd ? len + PFENG_TX_PKT_HEADER_SIZE : len))) {
+		net_err_ratelimited("%s: Packet overlimited.\n", netdev->name);
+		reason = PFENG_TXQ_DROP_OVERLIMITED;
+		goto busy_unmap;
+	}
+#endif /* PFE_CFG_HIF_TX_FIFO_FIX */
 
-		des = skb_frag_dma_map(netif->dev, frag, 0, plen, DMA_TO_DEVICE);
-		if (dma_mapping_error(netif->dev, des)) {
-			net_err_ratelimited("%s: Fragment mapping failed. Packet dropped. Error %d\n", netdev->name, dma_mapping_error(netif->dev, des));
-			pfeng_hif_chnl_txconf_unroll_map_full(chnl, refid - 1, f);
-			goto busy_drop;
-		}
+	/* Other producers may have consumed the space meanwhile */
+	if (unlikely(shared && !pfe_hif_chnl_can_accept_tx_num(chnl->priv, nbufs + hdr_bd))) {
+		reason = PFENG_TXQ_DROP_STOPPED;
+		goto busy_unmap;
+	}
 
-		ret = pfe_hif_chnl_tx(chnl->priv, (void *)des, frag, plen, (f + 1) >= nfrags);
-		if (unlikely(EOK != ret)) {
-			net_err_ratelimited("%s: HIF channel frag tx failed. Packet dropped. Error %d\n", netdev->name, ret);
-			pfeng_hif_chnl_txconf_unroll_map_full(chnl, refid - 1, f);
-			goto busy_drop;
-		}
+	/* Record the mappings before the buffers are handed over, confirmation may come anytime */
+	if (unlikely(hdr_bd)) {
+		hdr_va = pfeng_hif_chnl_txconf_copybreak_buf(chnl, &hdr_des);
+		memcpy(hdr_va, &hdr_tmp, sizeof(*hdr_va));
+		refid = pfeng_hif_chnl_txconf_put_map_frag(chnl, hdr_va, hdr_des, PFENG_TX_PKT_HEADER_SIZE, skb, PFENG_MAP_PKT_TX_HDR);
+		pfeng_hif_chnl_txconf_put_map_frag(chnl, bufs[0].va, bufs[0].des, bufs[0].len, NULL, PFENG_MAP_PKT_NORMAL);
+	} else {
+		refid = pfeng_hif_chnl_txconf_put_map_frag(chnl, bufs[0].va, bufs[0].des, bufs[0].len, skb, PFENG_MAP_PKT_NORMAL);
+	}
+	for (i = 1; i < nbufs; i++)
+		pfeng_hif_chnl_txconf_put_map_frag(chnl, bufs[i].va, bufs[i].des, bufs[i].len, NULL, PFENG_MAP_PKT_NORMAL);
+
+	/* Report to BQL before HW may see the frame. Trigger DMA at the end of burst only */
+	kick = __netdev_tx_sent_queue(txq, len, xmit_more);
+
+	/* Whole frame goes to the ring at once, or nothing of it */
+	if (unlikely(hdr_bd)) {
+		hw_bufs[0].buf_pa = (void *)hdr_des;
+		hw_bufs[0].len = PFENG_TX_PKT_HEADER_SIZE;
+		hw_bufs[0].lifm = false;
+		nhw = 1;
+	}
+	for (i = 0; i < nbufs; i++, nhw++) {
+		hw_bufs[nhw].buf_pa = (void *)bufs[i].des;
+		hw_bufs[nhw].len = bufs[i].len;
+		hw_bufs[nhw].lifm = (i + 1) == nbufs;
+	}
 
-		pfeng_hif_chnl_txconf_put_map_frag(chnl, frag, des, plen, NULL, PFENG_MAP_PKT_NORMAL);
+	ret = pfe_hif_chnl_tx_burst(chnl->priv, hw_bufs, nhw);
+	if (unlikely(EOK != ret)) {
+		net_err_ratelimited("%s: HIF channel tx failed. Packet dropped. Error %d\n", netdev->name, ret);
+		pfeng_hif_chnl_txconf_unroll_map_full(chnl, refid, nbufs - 1);
+		if (unlikely(shared))
+			spin_unlock(&chnl->lock_tx);
+		/* Frame never reached the ring, take it back from BQL */
+		netdev_tx_completed_queue(txq, 1, len);
+		goto drop;
 	}
 
-#ifndef PFE_CFG_MULTI_INSTANCE_SUPPORT
-	if (unlikely(chnl->cl_mode == PFENG_HIF_MODE_SHARED))
-#else
-	if (unlikely((chnl->cl_mode == PFENG_HIF_MODE_SHARED) || chnl->ihc))
-#endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
-#ifdef LOCK_TX_SPINLOCK
+	if (unlikely(shared))
 		spin_unlock(&chnl->lock_tx);
-#else
-		mutex_unlock(&chnl->lock_tx);
-#endif
 
-	netdev->stats.tx_packets++;
-	netdev->stats.tx_bytes += skb->len;
+	pfeng_netif_txq_stats_add(netif, queue, len, false);
+
+	/* Stop the queue early if the next frame may not fit */
+	if (unlikely(!pfe_hif_chnl_can_accept_tx_num(chnl->priv, MAX_SKB_FRAGS + 2))) {
+		pfeng_netif_txq_stop(netdev, chnl, queue);
+		kick = true;
+	}
+
+	if (kick)
+		pfe_hif_chnl_tx_dma_start(chnl->priv);
 
 	return NETDEV_TX_OK;
 
-busy_drop:
-#ifndef PFE_CFG_MULTI_INSTANCE_SUPPORT
-	if (unlikely(chnl->cl_mode == PFENG_HIF_MODE_SHARED))
-#else
-	if (unlikely((chnl->cl_mode == PFENG_HIF_MODE_SHARED) || chnl->ihc))
-#endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
-#ifdef LOCK_TX_SPINLOCK
+busy_unmap:
+	if (unlikely(shared))
 		spin_unlock(&chnl->lock_tx);
-#else
-		mutex_unlock(&chnl->lock_tx);
-#endif
-
-	netdev->stats.tx_dropped++;
+	pfeng_netif_logif_unmap_bufs(netif->dev, bufs, nbufs);
+	/* Frame will be requeued by the stack */
+	if (likely(!hdr_bd))
+		skb_pull(skb, PFENG_TX_PKT_HEADER_SIZE);
+	if (unlikely(ts_ref))
+		pfeng_hwts_release_tx_ref(netif, skb, ref_num);
+busy_stop:
+	pfeng_netif_txq_stop(netdev, chnl, queue);
+	/* Flush frames deferred by xmit_more */
+	pfe_hif_chnl_tx_dma_start(chnl->priv);
+	pfeng_netif_txq_stats_drop(netif, queue, reason);
 	return NETDEV_TX_BUSY;
 
+drop:
+	if (unlikely(ts_ref))
+		pfeng_hwts_release_tx_ref(netif, skb, ref_num);
+	pfe_hif_chnl_tx_dma_start(chnl->priv);
+	pfeng_netif_txq_stats_drop(netif, queue, reason);
+	dev_kfree_skb_any(skb);
+	return NETDEV_TX_OK;
 }
 
 #ifdef PFE_CFG_MULTI_INSTANCE_SUPPORT
@@ -364,11 +579,7 @@ void pfeng_ihc_tx_work_handler(struct work_struct *work)
 	int refid = -1, ret;
 
 	/* IHC transport requires protection */
-#ifdef LOCK_TX_SPINLOCK
-	spin_lock(&chnl->lock_tx);
-#else
-	mutex_lock(&chnl->lock_tx);
-#endif
+	spin_lock_bh(&chnl->lock_tx);
 
 	if (!kfifo_get(&priv->ihc_tx_fifo, &ihc_tx)) {
 		dev_err(chnl->dev, "No IHC TX data!\n");
@@ -376,9 +587,6 @@ void pfeng_ihc_tx_work_handler(struct work_struct *work)
 	}
 	skb = ihc_tx.skb;
 
-	/* Cleanup Tx HIF channel ring first */
-	pfeng_netif_logif_txack(chnl, 0 /* no NAPI */);
-
 	/* Remap skb */
 	des = dma_map_single(chnl->dev, skb->data, skb_headlen(skb), DMA_TO_DEVICE);
 	if (unlikely(dma_mapping_error(chnl->dev, des))) {
@@ -394,20 +602,12 @@ void pfeng_ihc_tx_work_handler(struct work_struct *work)
 		pfeng_hif_chnl_txconf_unroll_map_full(chnl, refid - 1, 0);
 		goto err;
 	}
-#ifdef LOCK_TX_SPINLOCK
-	spin_unlock(&chnl->lock_tx);
-#else
-	mutex_unlock(&chnl->lock_tx);
-#endif
+	spin_unlock_bh(&chnl->lock_tx);
 
 	return;
 
 err:
-#ifdef LOCK_TX_SPINLOCK
-	spin_unlock(&chnl->lock_tx);
-#else
-	mutex_unlock(&chnl->lock_tx);
-#endif
+	spin_unlock_bh(&chnl->lock_tx);
 	if(skb)
 		kfree_skb(skb);
 
@@ -494,13 +694,48 @@ static int pfeng_netif_logif_stop(struct net_device *netdev)
 	return 0;
 }
 
+#ifdef PFE_CFG_PFE_MASTER
+/* Let EMAC receive the frames of MTU size, the VLAN tag included */
+static int pfeng_netif_set_max_frame_length(struct pfeng_netif *netif, int mtu)
+{
+	pfe_emac_t *pfe_emac = netif->priv->pfe_platform->emac[netif->cfg->emac];
+
+	if (!pfe_emac)
+		return 0;
+
+	if (EOK != pfe_emac_set_max_frame_length(pfe_emac, mtu + VLAN_ETH_HLEN + ETH_FCS_LEN))
+		return -EINVAL;
+
+	return 0;
+}
+#endif /* PFE_CFG_PFE_MASTER */
+
 static int pfeng_netif_logif_change_mtu(struct net_device *netdev, int mtu)
 {
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	if (READ_ONCE(netif->xdp_prog) && mtu > PFENG_XDP_MAX_MTU) {
+		netdev_err(netdev, "MTU %d too large for XDP, maximum is %zu\n", mtu, PFENG_XDP_MAX_MTU);
+		return -EINVAL;
+	}
+
+#ifdef PFENG_CFG_XSK_SUPPORT
+	if (pfeng_xsk_check_mtu(netif, mtu)) {
+		netdev_err(netdev, "MTU %d too large for AF_XDP frame size\n", mtu);
+		return -EINVAL;
+	}
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
+#ifdef PFE_CFG_PFE_MASTER
+	if (pfeng_netif_set_max_frame_length(netif, mtu)) {
+		netdev_err(netdev, "EMAC can't receive frames for MTU %d\n", mtu);
+		return -EINVAL;
+	}
+#endif /* PFE_CFG_PFE_MASTER */
+
 	netdev->mtu = mtu;
 	netdev_update_features(netdev);
 
-	/* Note: Max packet size is not changed on PFE_EMAC */
-
 	return 0;
 }
 
@@ -559,8 +794,16 @@ static int pfeng_netif_logif_set_mac_address(struct net_device *netdev, void *p)
 
 		ret = pfe_log_if_add_mac_addr(emac->logif_emac, netdev->dev_addr, netif->priv->local_drv_id);
 	}
-	if (!ret)
+	if (!ret) {
+#ifdef PFE_CFG_PFE_MASTER
+		/* Steering logifs match the MAC address too */
+		if (pfeng_rss_set_mac(netif))
+			netdev_warn(netdev, "Can't update RSS Logifs with new MAC address\n");
+		if (pfeng_ntuple_set_mac(netif))
+			netdev_warn(netdev, "Can't update ntuple Logifs with new MAC address\n");
+#endif /* PFE_CFG_PFE_MASTER */
 		return 0;
+	}
 
 	return -ENOSPC;
 }
@@ -789,14 +1032,85 @@ static void pfeng_netif_logif_set_rx_mode(struct net_device *netdev)
 	return;
 }
 
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,2,0)
+static u16 pfeng_netif_logif_select_queue(struct net_device *netdev, struct sk_buff *skb,
+					  struct net_device *sb_dev)
+#else
+static u16 pfeng_netif_logif_select_queue(struct net_device *netdev, struct sk_buff *skb,
+					  struct net_device *sb_dev, select_queue_fallback_t fallback)
+#endif
+{
+	u16 queue;
+
+	/* Use XPS map if configured, flow hash otherwise */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,2,0)
+	queue = netdev_pick_tx(netdev, skb, sb_dev);
+#else
+	queue = fallback(netdev, skb, sb_dev);
+#endif
+
+	/* Only queues backed by mapped HIF channels are valid */
+	if (unlikely(queue >= netdev->real_num_tx_queues))
+		queue %= netdev->real_num_tx_queues;
+
+	return queue;
+}
+
+static void pfeng_netif_logif_get_stats64(struct net_device *netdev, struct rtnl_link_stats64 *stats)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+	struct pfeng_txq_stats *txq_stats;
+	struct pfeng_rxq_stats *rxq_stats;
+	u64 packets, bytes, dropped;
+	unsigned int start;
+	int q;
+
+	netdev_stats_to_stats64(stats, &netdev->stats);
+	stats->tx_dropped += atomic64_read(&netif->tx_map_chnl_failed);
+
+	/* Queues removed by ethtool -L keep their counters, the totals never go back */
+	for (q = 0; q < PFENG_PFE_HIF_CHANNELS; q++) {
+		txq_stats = &netif->txq_stats[q];
+		do {
+			start = u64_stats_fetch_begin(&txq_stats->syncp);
+			packets = txq_stats->packets;
+			bytes = txq_stats->bytes;
+			dropped = txq_stats->dropped;
+		} while (u64_stats_fetch_retry(&txq_stats->syncp, start));
+
+		stats->tx_packets += packets;
+		stats->tx_bytes += bytes;
+		stats->tx_dropped += dropped;
+
+		rxq_stats = &netif->rxq_stats[q];
+		do {
+			start = u64_stats_fetch_begin(&rxq_stats->syncp);
+			packets = rxq_stats->packets;
+			bytes = rxq_stats->bytes;
+			dropped = rxq_stats->dropped;
+		} while (u64_stats_fetch_retry(&rxq_stats->syncp, start));
+
+		stats->rx_packets += packets;
+		stats->rx_bytes += bytes;
+		stats->rx_dropped += dropped;
+	}
+}
+
 static const struct net_device_ops pfeng_netdev_ops = {
 	.ndo_open		= pfeng_netif_logif_open,
 	.ndo_start_xmit		= pfeng_netif_logif_xmit,
+	.ndo_select_queue	= pfeng_netif_logif_select_queue,
+	.ndo_get_stats64	= pfeng_netif_logif_get_stats64,
 	.ndo_stop		= pfeng_netif_logif_stop,
 	.ndo_change_mtu		= pfeng_netif_logif_change_mtu,
 	.ndo_do_ioctl		= pfeng_netif_logif_ioctl,
 	.ndo_set_mac_address	= pfeng_netif_logif_set_mac_address,
 	.ndo_set_rx_mode	= pfeng_netif_logif_set_rx_mode,
+	.ndo_bpf		= pfeng_xdp_bpf,
+	.ndo_xdp_xmit		= pfeng_xdp_xmit,
+#ifdef PFENG_CFG_XSK_SUPPORT
+	.ndo_xsk_wakeup		= pfeng_xsk_wakeup,
+#endif /* PFENG_CFG_XSK_SUPPORT */
 };
 
 static void pfeng_netif_detach_hifs(struct pfeng_netif *netif)
@@ -816,6 +1130,7 @@ static void pfeng_netif_detach_hifs(struct pfeng_netif *netif)
 			return;
 		}
 		chnl->netifs[netif->cfg->emac] = NULL;
+		pfeng_xdp_rxq_unreg(netif, chnl);
 		netdev_err(netdev, "Unsubscribe from HIF%u\n", chnl->idx);
 	}
 }
@@ -842,6 +1157,11 @@ static int pfeng_netif_attach_hifs(struct pfeng_netif *netif)
 			ret = -EINVAL;
 			goto err;
 		}
+		ret = pfeng_xdp_rxq_reg(netif, chnl);
+		if (ret) {
+			netdev_err(netdev, "Unable to register XDP RX queue of HIF%u\n", i);
+			goto err;
+		}
 		chnl->netifs[netif->cfg->emac] = netif;
 		netdev_err(netdev, "Subscribe to HIF%u\n", chnl->idx);
 	}
@@ -865,8 +1185,14 @@ static void pfeng_netif_logif_remove(struct pfeng_netif *netif)
 #endif /* PFE_CFG_PFE_SLAVE */
 
 #ifdef PFE_CFG_PFE_MASTER
+	pfeng_ethtool_stats_stop(netif);
+
 	if (netif->phylink)
 		pfeng_phylink_destroy(netif);
+
+	/* RSS and ntuple logifs are chained to EMAC phyif too */
+	pfeng_ntuple_stop(netif, true);
+	pfeng_rss_stop(netif, true);
 #endif /* PFE_CFG_PFE_MASTER */
 
 	/* Stop EMAC logif */
@@ -894,13 +1220,8 @@ static void pfeng_netif_logif_remove(struct pfeng_netif *netif)
 	free_netdev(netif->netdev);
 }
 
-/**
- * @brief	Fetch necessary PFE Platform interfaces
- * @param[in]	netif Net interface instance
- * @return	0 OK
- *
- */
-static int pfeng_netif_control_platform_ifs(struct pfeng_netif *netif)
+/* Forward EMAC ingress traffic to the HIF channel(s) of hifmap */
+static int pfeng_netif_control_hifs(struct pfeng_netif *netif)
 {
 	struct net_device *netdev = netif->netdev;
 	struct pfeng_priv *priv = netif->priv;
@@ -908,37 +1229,6 @@ static int pfeng_netif_control_platform_ifs(struct pfeng_netif *netif)
 	struct pfeng_hif_chnl *chnl;
 	int ret, i;
 
-	/* Create PFE platform-wide pool of interfaces */
-	if (pfe_platform_create_ifaces(priv->pfe_platform)) {
-		netdev_err(netdev, "Can't init platform interfaces\n");
-		goto err;
-	}
-
-	/* Prefetch linked EMAC interfaces */
-	if (!emac->phyif_emac) {
-		emac->phyif_emac = pfe_platform_get_phy_if_by_id(priv->pfe_platform, netif->cfg->emac);
-		if (!emac->phyif_emac) {
-			netdev_err(netdev, "Could not get linked EMAC physical interface\n");
-			goto err;
-		}
-	}
-	if (!emac->logif_emac) {
-		emac->logif_emac = pfe_log_if_create(emac->phyif_emac, (char *)netif->cfg->name);
-		if (!emac->logif_emac) {
-			netdev_err(netdev, "EMAC Logif can't be created: %s\n", netif->cfg->name);
-			goto err;
-		} else {
-			ret = pfe_platform_register_log_if(priv->pfe_platform, emac->logif_emac);
-			if (ret) {
-				netdev_err(netdev, "Can't register EMAC Logif\n");
-				goto err;
-			}
-		}
-		netdev_dbg(netdev, "EMAC Logif created: %s @%px\n", netif->cfg->name, emac->logif_emac);
-	}
-	else
-		netdev_dbg(netdev, "EMAC Logif reused: %s @%px\n", netif->cfg->name, emac->logif_emac);
-
 	/* Make sure that EMAC ingress traffic will be forwarded to respective HIF channel */
 	i = ffs(netif->cfg->hifmap) - 1;
 #ifdef PFE_CFG_PFE_MASTER
@@ -952,7 +1242,7 @@ static int pfeng_netif_control_platform_ifs(struct pfeng_netif *netif)
 #endif /* PFE_CFG_PFE_MASTER */
 	if (EOK != ret) {
 		netdev_err(netdev, "Can't set EMAC egress interface\n");
-		goto err;
+		return -EINVAL;
 	}
 
 	/* Prefetch linked HIF(s) */
@@ -964,7 +1254,7 @@ static int pfeng_netif_control_platform_ifs(struct pfeng_netif *netif)
 			chnl->phyif_hif = pfe_platform_get_phy_if_by_id(priv->pfe_platform, pfeng_hif_ids[i]);
 			if (!chnl->phyif_hif) {
 				netdev_err(netdev, "Could not get HIF%u physical interface\n", i);
-				goto err;
+				return -EINVAL;
 			}
 		}
 
@@ -974,7 +1264,7 @@ static int pfeng_netif_control_platform_ifs(struct pfeng_netif *netif)
 			ret = pfe_phy_if_loadbalance_enable(chnl->phyif_hif);
 			if (EOK != ret) {
 				netdev_err(netdev, "Can't set loadbalancing mode to HIF%u\n", i);
-				goto err;
+				return -EINVAL;
 			} else
 				netdev_info(netdev, "add HIF%u loadbalance\n", i);
 #else
@@ -985,11 +1275,63 @@ static int pfeng_netif_control_platform_ifs(struct pfeng_netif *netif)
 		ret = pfe_phy_if_enable(chnl->phyif_hif);
 		if (EOK != ret) {
 			netdev_err(netdev, "Can't enable HIF%u\n", i);
-			goto err;
+			return -EINVAL;
 		}
 		netdev_info(netdev, "Enable HIF%u\n", i);
 	}
 
+	return 0;
+}
+
+/**
+ * @brief	Fetch necessary PFE Platform interfaces
+ * @param[in]	netif Net interface instance
+ * @return	0 OK
+ *
+ */
+static int pfeng_netif_control_platform_ifs(struct pfeng_netif *netif)
+{
+	struct net_device *netdev = netif->netdev;
+	struct pfeng_priv *priv = netif->priv;
+	struct pfeng_emac *emac = &priv->emac[netif->cfg->emac];
+	int ret;
+
+	/* Create PFE platform-wide pool of interfaces */
+	if (pfe_platform_create_ifaces(priv->pfe_platform)) {
+		netdev_err(netdev, "Can't init platform interfaces\n");
+		goto err;
+	}
+
+	/* Prefetch linked EMAC interfaces */
+	if (!emac->phyif_emac) {
+		emac->phyif_emac = pfe_platform_get_phy_if_by_id(priv->pfe_platform, netif->cfg->emac);
+		if (!emac->phyif_emac) {
+			netdev_err(netdev, "Could not get linked EMAC physical interface\n");
+			goto err;
+		}
+	}
+	if (!emac->logif_emac) {
+		emac->logif_emac = pfe_log_if_create(emac->phyif_emac, (char *)netif->cfg->name);
+		if (!emac->logif_emac) {
+			netdev_err(netdev, "EMAC Logif can't be created: %s\n", netif->cfg->name);
+			goto err;
+		} else {
+			ret = pfe_platform_register_log_if(priv->pfe_platform, emac->logif_emac);
+			if (ret) {
+				netdev_err(netdev, "Can't register EMAC Logif\n");
+				goto err;
+			}
+		}
+		netdev_dbg(netdev, "EMAC Logif created: %s @%px\n", netif->cfg->name, emac->logif_emac);
+	}
+	else
+		netdev_dbg(netdev, "EMAC Logif reused: %s @%px\n", netif->cfg->name, emac->logif_emac);
+
+	/* Route EMAC ingress traffic to the HIF channel(s) */
+	ret = pfeng_netif_control_hifs(netif);
+	if (ret)
+		goto err;
+
 	/* Add rule for local MAC */
 	if (!netif->cfg->tx_inject) {
 		/* Configure the logical interface to accept frames matching local MAC address */
@@ -1033,6 +1375,22 @@ static int pfeng_netif_logif_init_second_stage(struct pfeng_netif *netif)
 		memset(&saddr.sa_data, 0, sizeof(saddr.sa_data));
 	pfeng_netif_logif_set_mac_address(netdev, (void *)&saddr);
 
+#ifdef PFE_CFG_PFE_MASTER
+	/* Platform starts with the standard frame size (resume too) */
+	if (pfeng_netif_set_max_frame_length(netif, netdev->mtu))
+		netdev_warn(netdev, "Cannot set EMAC max frame length for MTU %u\n", netdev->mtu);
+
+	/* Steer flows to HIF channels, loadbalancing is used on failure */
+	ret = pfeng_rss_start(netif);
+	if (ret)
+		netdev_warn(netdev, "Cannot set RSS: %d\n", ret);
+
+	/* Created last to be matched before RSS */
+	ret = pfeng_ntuple_start(netif);
+	if (ret)
+		netdev_warn(netdev, "Cannot set ntuple rules: %d\n", ret);
+#endif /* PFE_CFG_PFE_MASTER */
+
 	/* Init hw timestamp */
 	ret = pfeng_hwts_init(netif);
 	if (ret) {
@@ -1072,7 +1430,7 @@ static struct pfeng_netif *pfeng_netif_logif_create(struct pfeng_priv *priv, str
 	struct device *dev = &priv->pdev->dev;
 	struct pfeng_netif *netif;
 	struct net_device *netdev;
-	int ret;
+	int ret, i;
 
 	if (!netif_cfg->name || !strlen(netif_cfg->name)) {
 		dev_err(dev, "Interface name is missing: %s\n", netif_cfg->name);
@@ -1108,25 +1466,38 @@ static struct pfeng_netif *pfeng_netif_logif_create(struct pfeng_priv *priv, str
 
 	/* MTU ranges */
 	netdev->min_mtu = ETH_MIN_MTU;
-	netdev->max_mtu = ETH_DATA_LEN;
+	netdev->max_mtu = PFENG_MAX_MTU;
+
+	netif->tx_copybreak = PFENG_TX_COPYBREAK_DEF;
 
 	/* Each packet requires extra buffer for Tx header (metadata) */
 	netdev->needed_headroom = PFENG_TX_PKT_HEADER_SIZE;
 
 #ifdef PFE_CFG_PFE_MASTER
 	pfeng_ethtool_init(netdev);
+	pfeng_rss_init(netif);
+	pfeng_ntuple_init(netif);
 
 	/* Add phylink */
 	if (priv->emac[netif_cfg->emac].intf_mode != PHY_INTERFACE_MODE_INTERNAL)
 		pfeng_phylink_create(netif);
 #endif
 
-	INIT_WORK(&netif->tx_conf_work, pfeng_netif_tx_conf);
+	/* One TX queue per mapped HIF channel */
+	pfeng_netif_map_tx_queues(netif);
+	for (i = 0; i < PFENG_PFE_HIF_CHANNELS; i++) {
+		u64_stats_init(&netif->txq_stats[i].syncp);
+		u64_stats_init(&netif->rxq_stats[i].syncp);
+	}
+	atomic64_set(&netif->tx_map_chnl_failed, 0);
 
 	/* Accelerated feature */
 	netdev->hw_features |= NETIF_F_IP_CSUM | NETIF_F_IPV6_CSUM | NETIF_F_RXCSUM;
 	netdev->hw_features |= NETIF_F_SG;
 	netdev->features = netdev->hw_features;
+#ifdef PFE_CFG_PFE_MASTER
+	netdev->features |= NETIF_F_NTUPLE;
+#endif /* PFE_CFG_PFE_MASTER */
 
 	ret = register_netdev(netdev);
 	if (ret) {
@@ -1173,6 +1544,8 @@ static struct pfeng_netif *pfeng_netif_logif_create(struct pfeng_priv *priv, str
 		goto err_netdev_reg;
 
 #ifdef PFE_CFG_PFE_MASTER
+	pfeng_ethtool_stats_start(netif);
+
 	if (netif->phylink) {
 		ret = pfeng_phylink_connect_phy(netif);
 		if (ret)
@@ -1210,6 +1583,210 @@ int pfeng_netif_create(struct pfeng_priv *priv)
 	return ret;
 }
 
+#ifdef PFE_CFG_PFE_MASTER
+/* HIF channel not used by the netif, which can be added to its hifmap */
+static bool pfeng_netif_chnl_available(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, u32 idx)
+{
+	int i;
+
+	if (netif->cfg->hifmap & BIT(idx))
+		return false;
+
+	if (chnl->status != PFENG_HIF_STATUS_ENABLED && chnl->status != PFENG_HIF_STATUS_RUNNING)
+		return false;
+
+	if (chnl->ihc)
+		return false;
+
+	if (chnl->cl_mode == PFENG_HIF_MODE_SHARED)
+		return !chnl->netifs[netif->cfg->emac];
+
+	/* Exclusive channel serves single netif only */
+	for (i = 0; i < HIF_CLIENTS_MAX; i++)
+		if (chnl->netifs[i])
+			return false;
+
+	return true;
+}
+
+/* Loadbalancing of HIF channel is kept while other multi-HIF netif uses it */
+static bool pfeng_netif_chnl_lb_used(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl)
+{
+	int i;
+
+	for (i = 0; i < HIF_CLIENTS_MAX; i++)
+		if (chnl->netifs[i] && chnl->netifs[i] != netif && chnl->netifs[i]->cfg->hifs > 1)
+			return true;
+
+	return false;
+}
+
+/**
+ * @brief	Get maximum number of HIF channels the netif can use
+ * @param[in]	netif Net interface instance
+ * @return	Number of channels in hifmap plus the free ones
+ */
+u32 pfeng_netif_get_max_hifs(struct pfeng_netif *netif)
+{
+	struct pfeng_hif_chnl *chnl;
+	u32 cnt = netif->cfg->hifs;
+	int i;
+
+	pfeng_netif_for_each_chnl(netif, i, chnl)
+		if (pfeng_netif_chnl_available(netif, chnl, i))
+			cnt++;
+
+	return cnt;
+}
+
+/**
+ * @brief	Change number of HIF channels serving the netif
+ * @details	Channels are dropped from the top of hifmap, free channels with
+ *		the lowest index are added. Each channel is one RX/TX queue pair.
+ *		Traffic of all affected channels is stopped meanwhile, RSS and
+ *		ntuple logifs are recreated for the new queues. Caller holds rtnl.
+ * @param[in]	netif Net interface instance
+ * @param[in]	count New number of HIF channels
+ * @return	0 OK
+ */
+int pfeng_netif_set_hifs(struct pfeng_netif *netif, u32 count)
+{
+	struct net_device *netdev = netif->netdev;
+	u32 old_map = netif->cfg->hifmap;
+	u32 old_cnt = netif->cfg->hifs;
+	u32 new_map = old_map, quiesced = 0;
+	struct pfeng_hif_chnl *chnl;
+	int ret = 0, err, i;
+
+	if (!count || count > pfeng_netif_get_max_hifs(netif))
+		return -EINVAL;
+
+	while (hweight32(new_map) > count)
+		new_map &= ~BIT(fls(new_map) - 1);
+
+	pfeng_netif_for_each_chnl(netif, i, chnl) {
+		if (hweight32(new_map) == count)
+			break;
+		if (pfeng_netif_chnl_available(netif, chnl, i))
+			new_map |= BIT(i);
+	}
+
+	if (new_map == old_map)
+		return 0;
+
+#ifdef PFENG_CFG_XSK_SUPPORT
+	/* AF_XDP sockets are bound to queue ids, which would move */
+	pfeng_netif_for_each_chnl(netif, i, chnl) {
+		if ((old_map & BIT(i)) && chnl->xsk_netif == netif) {
+			netdev_err(netdev, "HIF channels can't be changed with AF_XDP zero-copy on HIF%u\n", i);
+			return -EBUSY;
+		}
+	}
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
+	/* Flow steering must point to remaining queues only */
+	if (pfeng_ntuple_get_rings(netif) > count) {
+		netdev_err(netdev, "ntuple rule targets queue above %u\n", count - 1);
+		return -EINVAL;
+	}
+	ret = pfeng_rss_set_queues(netif, count);
+	if (ret) {
+		netdev_err(netdev, "RSS indirection table targets queue above %u\n", count - 1);
+		return ret;
+	}
+
+	if (netif_running(netdev))
+		netif_tx_disable(netdev);
+
+	/* Queue of the netif is derived from hifmap, stop all affected channels */
+	pfeng_netif_for_each_chnl(netif, i, chnl) {
+		if (!((old_map | new_map) & BIT(i)) || chnl->status != PFENG_HIF_STATUS_RUNNING)
+			continue;
+
+		quiesced |= BIT(i);
+		ret = pfeng_hif_chnl_quiesce(chnl);
+		if (ret) {
+			pfeng_rss_set_queues(netif, old_cnt);
+			goto resume;
+		}
+	}
+
+	pfeng_ntuple_stop(netif, true);
+	pfeng_rss_stop(netif, true);
+	pfeng_netif_detach_hifs(netif);
+
+	/* Channels leaving loadbalancing */
+	pfeng_netif_for_each_chnl(netif, i, chnl) {
+		if (!(old_map & BIT(i)) || old_cnt < 2 || !chnl->phyif_hif)
+			continue;
+		if ((new_map & BIT(i)) && count > 1)
+			continue;
+
+		if (!pfeng_netif_chnl_lb_used(netif, chnl) &&
+		    EOK != pfe_phy_if_loadbalance_disable(chnl->phyif_hif))
+			netdev_warn(netdev, "Can't remove HIF%u loadbalance\n", i);
+	}
+
+	netif->cfg->hifmap = new_map;
+	netif->cfg->hifs = count;
+	pfeng_netif_map_tx_queues(netif);
+
+	ret = pfeng_netif_attach_hifs(netif);
+	if (!ret)
+		ret = pfeng_netif_control_hifs(netif);
+	if (ret) {
+		netdev_err(netdev, "Can't use %u HIF channels: %d\n", count, ret);
+
+		/* Go back to the original channels */
+		pfeng_netif_detach_hifs(netif);
+		netif->cfg->hifmap = old_map;
+		netif->cfg->hifs = old_cnt;
+		pfeng_netif_map_tx_queues(netif);
+		pfeng_rss_set_queues(netif, old_cnt);
+
+		err = pfeng_netif_attach_hifs(netif);
+		if (!err)
+			err = pfeng_netif_control_hifs(netif);
+		if (err)
+			netdev_err(netdev, "HIF channels are inconsistent: %d\n", err);
+	}
+
+	netif_set_real_num_rx_queues(netdev, netif->cfg->hifs);
+	netif_set_real_num_tx_queues(netdev, netif->cfg->hifs);
+	for (i = 0; i < netif->cfg->hifs; i++)
+		netdev_tx_reset_queue(netdev_get_tx_queue(netdev, i));
+
+	err = pfeng_rss_start(netif);
+	if (err)
+		netdev_warn(netdev, "Cannot set RSS: %d\n", err);
+
+	err = pfeng_ntuple_start(netif);
+	if (err)
+		netdev_warn(netdev, "Cannot set ntuple rules: %d\n", err);
+
+	/* Channels new to the netif are started as on open */
+	if (netif_running(netdev)) {
+		pfeng_netif_for_each_chnl(netif, i, chnl) {
+			if ((netif->cfg->hifmap & BIT(i)) && chnl->status == PFENG_HIF_STATUS_ENABLED)
+				pfeng_hif_chnl_start(chnl);
+		}
+	}
+
+	netdev_info(netdev, "HIFs: count %u map %02x\n", netif->cfg->hifs, netif->cfg->hifmap);
+
+resume:
+	pfeng_netif_for_each_chnl(netif, i, chnl) {
+		if (quiesced & BIT(i))
+			pfeng_hif_chnl_resume(chnl);
+	}
+
+	if (netif_running(netdev))
+		netif_tx_wake_all_queues(netdev);
+
+	return ret;
+}
+#endif /* PFE_CFG_PFE_MASTER */
+
 static int pfeng_netif_logif_suspend(struct pfeng_netif *netif)
 {
 	struct pfeng_emac *emac = &netif->priv->emac[netif->cfg->emac];
@@ -1218,6 +1795,7 @@ static int pfeng_netif_logif_suspend(struct pfeng_netif *netif)
 
 #ifdef PFE_CFG_PFE_MASTER
 	pfeng_phylink_mac_change(netif, false);
+	pfeng_ethtool_stats_stop(netif);
 #endif /* PFE_CFG_PFE_MASTER */
 
 	netif_device_detach(netif->netdev);
@@ -1252,6 +1830,12 @@ static int pfeng_netif_logif_suspend(struct pfeng_netif *netif)
 			chnl->phyif_hif = NULL;
 	}
 
+#ifdef PFE_CFG_PFE_MASTER
+	/* RSS and ntuple logifs are released with platform, keep the configuration only */
+	pfeng_ntuple_stop(netif, false);
+	pfeng_rss_stop(netif, false);
+#endif /* PFE_CFG_PFE_MASTER */
+
 	/* Reset linked EMAC IFs */
 	emac->phyif_emac = NULL;
 	emac->logif_emac = NULL;
@@ -1296,6 +1880,10 @@ static int pfeng_netif_logif_resume(struct pfeng_netif *netif)
 
 
 	ret = pfeng_netif_logif_init_second_stage(netif);
+#ifdef PFE_CFG_PFE_MASTER
+	if (!ret)
+		pfeng_ethtool_stats_start(netif);
+#endif /* PFE_CFG_PFE_MASTER */
 
 	/* start HIF channel(s) */
 	pfeng_netif_for_each_chnl(netif, i, chnl) {
@@ -0,0 +1,651 @@
+/*
+ * Copyright 2021 NXP
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ *
+ */
+
+#include <linux/ethtool.h>
+#include <linux/if_vlan.h>
+
+#include "pfe_cfg.h"
+#include "oal.h"
+#include "pfe_platform.h"
+#include "pfe_fp.h"
+
+#include "pfeng.h"
+
+/*
+ * Each ethtool ntuple rule is compiled into own logif on the EMAC phyif.
+ * Packet type is checked by the logif match rules, the masked header
+ * fields by its FP table: every field is one rule rejecting the packet
+ * on mismatch (INVERT | REJECT), the last rule accepts anything else.
+ * Logifs are chained in front of the RSS and EMAC logifs, the one with
+ * lowest location is the first one.
+ */
+
+/* Logif match rules and the FP table of one ntuple rule */
+struct pfeng_ntuple_prog {
+	u32				m_rules;
+	__be16				ethtype;
+	pfe_ct_fp_rule_t		fp[PFENG_NTUPLE_FP_RULES];
+	u8				fp_cnt;
+};
+
+static int pfeng_ntuple_fp_add(struct pfeng_ntuple_prog *prog, u16 offset, u8 flags, u32 data, u32 mask)
+{
+	pfe_ct_fp_rule_t *rule;
+
+	if (!mask)
+		return 0;
+
+	/* Keep one rule for the final ACCEPT */
+	if (prog->fp_cnt >= PFENG_NTUPLE_FP_RULES - 1)
+		return -E2BIG;
+
+	rule = &prog->fp[prog->fp_cnt++];
+	rule->data = oal_htonl(data & mask);
+	rule->mask = oal_htonl(mask);
+	rule->offset = oal_htons(offset);
+	rule->next_idx = 0xffU;
+	rule->flags = FP_FL_INVERT | FP_FL_REJECT | flags;
+
+	return 0;
+}
+
+/* Up to 4 bytes of frame data as they are read by the FP rule */
+static u32 pfeng_ntuple_word(const u8 *p, u32 len)
+{
+	u32 i, word = 0;
+
+	for (i = 0; i < 4; i++)
+		word = (word << 8) | (i < len ? p[i] : 0);
+
+	return word;
+}
+
+static int pfeng_ntuple_fp_add_mac(struct pfeng_ntuple_prog *prog, u16 offset, const u8 *addr, const u8 *mask)
+{
+	int ret;
+
+	ret = pfeng_ntuple_fp_add(prog, offset, 0, pfeng_ntuple_word(addr, 4), pfeng_ntuple_word(mask, 4));
+	if (ret)
+		return ret;
+
+	return pfeng_ntuple_fp_add(prog, offset + 4, 0, pfeng_ntuple_word(addr + 4, 2), pfeng_ntuple_word(mask + 4, 2));
+}
+
+static int pfeng_ntuple_fp_add_ip6(struct pfeng_ntuple_prog *prog, u16 offset, const __be32 *addr, const __be32 *mask)
+{
+	int i, ret;
+
+	for (i = 0; i < 4; i++) {
+		ret = pfeng_ntuple_fp_add(prog, offset + i * 4, FP_FL_L3_OFFSET, be32_to_cpu(addr[i]), be32_to_cpu(mask[i]));
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* Both L4 ports are in the first word of L4 header */
+static int pfeng_ntuple_fp_add_ports(struct pfeng_ntuple_prog *prog, __be16 psrc, __be16 pdst, __be16 mpsrc, __be16 mpdst)
+{
+	return pfeng_ntuple_fp_add(prog, 0, FP_FL_L4_OFFSET,
+				   ((u32)be16_to_cpu(psrc) << 16) | be16_to_cpu(pdst),
+				   ((u32)be16_to_cpu(mpsrc) << 16) | be16_to_cpu(mpdst));
+}
+
+static u8 pfeng_ntuple_l4_proto(u32 flow_type)
+{
+	switch (flow_type) {
+	case TCP_V4_FLOW:
+	case TCP_V6_FLOW:
+		return IPPROTO_TCP;
+	case UDP_V4_FLOW:
+	case UDP_V6_FLOW:
+		return IPPROTO_UDP;
+	default:
+		return IPPROTO_SCTP;
+	}
+}
+
+static int pfeng_ntuple_compile_ip4(struct pfeng_ntuple_prog *prog, struct ethtool_rx_flow_spec *fs, u32 flow_type)
+{
+	const struct ethtool_tcpip4_spec *h = &fs->h_u.tcp_ip4_spec, *m = &fs->m_u.tcp_ip4_spec;
+	int ret;
+
+	prog->m_rules |= IF_MATCH_TYPE_IPV4;
+
+	/* Protocol is at offset 9 of IPv4 header */
+	ret = pfeng_ntuple_fp_add(prog, 9, FP_FL_L3_OFFSET, (u32)pfeng_ntuple_l4_proto(flow_type) << 24, 0xff000000U);
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 1, FP_FL_L3_OFFSET, (u32)h->tos << 24, (u32)m->tos << 24);
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 12, FP_FL_L3_OFFSET, be32_to_cpu(h->ip4src), be32_to_cpu(m->ip4src));
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 16, FP_FL_L3_OFFSET, be32_to_cpu(h->ip4dst), be32_to_cpu(m->ip4dst));
+	ret = ret ?: pfeng_ntuple_fp_add_ports(prog, h->psrc, h->pdst, m->psrc, m->pdst);
+
+	return ret;
+}
+
+static int pfeng_ntuple_compile_usr_ip4(struct pfeng_ntuple_prog *prog, struct ethtool_rx_flow_spec *fs)
+{
+	const struct ethtool_usrip4_spec *h = &fs->h_u.usr_ip4_spec, *m = &fs->m_u.usr_ip4_spec;
+	int ret;
+
+	if (h->ip_ver != ETH_RX_NFC_IP4)
+		return -EINVAL;
+
+	prog->m_rules |= IF_MATCH_TYPE_IPV4;
+
+	ret = pfeng_ntuple_fp_add(prog, 9, FP_FL_L3_OFFSET, (u32)h->proto << 24, (u32)m->proto << 24);
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 1, FP_FL_L3_OFFSET, (u32)h->tos << 24, (u32)m->tos << 24);
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 12, FP_FL_L3_OFFSET, be32_to_cpu(h->ip4src), be32_to_cpu(m->ip4src));
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 16, FP_FL_L3_OFFSET, be32_to_cpu(h->ip4dst), be32_to_cpu(m->ip4dst));
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 0, FP_FL_L4_OFFSET, be32_to_cpu(h->l4_4_bytes), be32_to_cpu(m->l4_4_bytes));
+
+	return ret;
+}
+
+static int pfeng_ntuple_compile_ip6(struct pfeng_ntuple_prog *prog, struct ethtool_rx_flow_spec *fs, u32 flow_type)
+{
+	const struct ethtool_tcpip6_spec *h = &fs->h_u.tcp_ip6_spec, *m = &fs->m_u.tcp_ip6_spec;
+	int ret;
+
+	prog->m_rules |= IF_MATCH_TYPE_IPV6;
+
+	/* Next header is at offset 6, traffic class follows the version nibble */
+	ret = pfeng_ntuple_fp_add(prog, 6, FP_FL_L3_OFFSET, (u32)pfeng_ntuple_l4_proto(flow_type) << 24, 0xff000000U);
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 0, FP_FL_L3_OFFSET, (u32)h->tclass << 20, (u32)m->tclass << 20);
+	ret = ret ?: pfeng_ntuple_fp_add_ip6(prog, 8, h->ip6src, m->ip6src);
+	ret = ret ?: pfeng_ntuple_fp_add_ip6(prog, 24, h->ip6dst, m->ip6dst);
+	ret = ret ?: pfeng_ntuple_fp_add_ports(prog, h->psrc, h->pdst, m->psrc, m->pdst);
+
+	return ret;
+}
+
+static int pfeng_ntuple_compile_usr_ip6(struct pfeng_ntuple_prog *prog, struct ethtool_rx_flow_spec *fs)
+{
+	const struct ethtool_usrip6_spec *h = &fs->h_u.usr_ip6_spec, *m = &fs->m_u.usr_ip6_spec;
+	int ret;
+
+	prog->m_rules |= IF_MATCH_TYPE_IPV6;
+
+	ret = pfeng_ntuple_fp_add(prog, 6, FP_FL_L3_OFFSET, (u32)h->l4_proto << 24, (u32)m->l4_proto << 24);
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 0, FP_FL_L3_OFFSET, (u32)h->tclass << 20, (u32)m->tclass << 20);
+	ret = ret ?: pfeng_ntuple_fp_add_ip6(prog, 8, h->ip6src, m->ip6src);
+	ret = ret ?: pfeng_ntuple_fp_add_ip6(prog, 24, h->ip6dst, m->ip6dst);
+	ret = ret ?: pfeng_ntuple_fp_add(prog, 0, FP_FL_L4_OFFSET, be32_to_cpu(h->l4_4_bytes), be32_to_cpu(m->l4_4_bytes));
+
+	return ret;
+}
+
+static int pfeng_ntuple_compile_ether(struct pfeng_ntuple_prog *prog, struct ethtool_rx_flow_spec *fs)
+{
+	const struct ethhdr *h = &fs->h_u.ether_spec, *m = &fs->m_u.ether_spec;
+	int ret;
+
+	/* Logif EtherType match skips VLAN tags, it can't be masked */
+	if (m->h_proto) {
+		if (m->h_proto != htons(0xffff))
+			return -EINVAL;
+		prog->m_rules |= IF_MATCH_ETHTYPE;
+		prog->ethtype = h->h_proto;
+	}
+
+	ret = pfeng_ntuple_fp_add_mac(prog, 0, h->h_dest, m->h_dest);
+	ret = ret ?: pfeng_ntuple_fp_add_mac(prog, ETH_ALEN, h->h_source, m->h_source);
+
+	return ret;
+}
+
+static int pfeng_ntuple_compile_ext(struct pfeng_ntuple_prog *prog, struct ethtool_rx_flow_spec *fs)
+{
+	u32 tpid = ETH_P_8021Q;
+	int ret = 0;
+
+	if (fs->flow_type & FLOW_EXT) {
+		if (fs->m_ext.data[0] || fs->m_ext.data[1])
+			return -EINVAL;
+
+		/* Outer TPID and TCI make the word following the MAC addresses */
+		if (fs->m_ext.vlan_etype || fs->m_ext.vlan_tci) {
+			if (fs->m_ext.vlan_etype)
+				tpid = be16_to_cpu(fs->h_ext.vlan_etype);
+			ret = pfeng_ntuple_fp_add(prog, 2 * ETH_ALEN, 0,
+						  (tpid << 16) | be16_to_cpu(fs->h_ext.vlan_tci),
+						  0xffff0000U | be16_to_cpu(fs->m_ext.vlan_tci));
+		}
+	}
+
+	if (!ret && (fs->flow_type & FLOW_MAC_EXT))
+		ret = pfeng_ntuple_fp_add_mac(prog, 0, fs->h_ext.h_dest, fs->m_ext.h_dest);
+
+	return ret;
+}
+
+static int pfeng_ntuple_compile(struct ethtool_rx_flow_spec *fs, struct pfeng_ntuple_prog *prog)
+{
+	u32 flow_type = fs->flow_type & ~(FLOW_EXT | FLOW_MAC_EXT);
+	int ret;
+
+	memset(prog, 0, sizeof(*prog));
+
+	switch (flow_type) {
+	case TCP_V4_FLOW:
+	case UDP_V4_FLOW:
+	case SCTP_V4_FLOW:
+		ret = pfeng_ntuple_compile_ip4(prog, fs, flow_type);
+		break;
+	case IPV4_USER_FLOW:
+		ret = pfeng_ntuple_compile_usr_ip4(prog, fs);
+		break;
+	case TCP_V6_FLOW:
+	case UDP_V6_FLOW:
+	case SCTP_V6_FLOW:
+		ret = pfeng_ntuple_compile_ip6(prog, fs, flow_type);
+		break;
+	case IPV6_USER_FLOW:
+		ret = pfeng_ntuple_compile_usr_ip6(prog, fs);
+		break;
+	case ETHER_FLOW:
+		ret = pfeng_ntuple_compile_ether(prog, fs);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	ret = ret ?: pfeng_ntuple_compile_ext(prog, fs);
+	if (ret)
+		return ret;
+
+	/* Anything not rejected so far matches */
+	prog->fp[prog->fp_cnt].next_idx = 0xffU;
+	prog->fp[prog->fp_cnt].flags = FP_FL_ACCEPT;
+	prog->fp_cnt++;
+
+	return 0;
+}
+
+static int pfeng_ntuple_check_action(struct pfeng_netif *netif, struct ethtool_rx_flow_spec *fs)
+{
+	if (fs->ring_cookie == RX_CLS_FLOW_DISC)
+		return 0;
+
+	if (ethtool_get_flow_spec_ring_vf(fs->ring_cookie) ||
+	    ethtool_get_flow_spec_ring(fs->ring_cookie) >= netif->cfg->hifs)
+		return -EINVAL;
+
+	return 0;
+}
+
+static u32 pfeng_ntuple_create_table(struct pfeng_netif *netif, struct pfeng_ntuple_prog *prog)
+{
+	pfe_class_t *class = netif->priv->pfe_platform->classifier;
+	u32 addr;
+	u8 i;
+
+	addr = pfe_fp_create_table(class, prog->fp_cnt);
+	if (!addr)
+		return 0;
+
+	for (i = 0; i < prog->fp_cnt; i++) {
+		if (!pfe_fp_table_write_rule(class, addr, &prog->fp[i], i)) {
+			pfe_fp_destroy_table(class, addr);
+			return 0;
+		}
+	}
+
+	return addr;
+}
+
+static pfe_log_if_t *pfeng_ntuple_logif_create(struct pfeng_netif *netif, struct ethtool_rx_flow_spec *fs,
+					       struct pfeng_ntuple_prog *prog, u32 table)
+{
+	struct pfeng_priv *priv = netif->priv;
+	pfe_phy_if_t *phyif_emac = priv->emac[netif->cfg->emac].phyif_emac;
+	PFE_PTR(pfe_ct_fp_table_t) fp_table = oal_htonl(table);
+	char name[IFNAMSIZ + 8];
+	pfe_log_if_t *logif;
+	u32 ring;
+	int ret;
+
+	scnprintf(name, sizeof(name), "%sfs%u", netif->cfg->name, fs->location);
+	logif = pfe_log_if_create(phyif_emac, name);
+	if (!logif)
+		return NULL;
+
+	ret = pfe_platform_register_log_if(priv->pfe_platform, logif);
+	if (ret) {
+		pfe_log_if_destroy(logif);
+		return NULL;
+	}
+
+	if (fs->ring_cookie == RX_CLS_FLOW_DISC) {
+		ret = pfe_log_if_discard_enable(logif);
+	} else {
+		ring = ethtool_get_flow_spec_ring(fs->ring_cookie);
+		ret = pfe_log_if_set_egress_ifs(logif, 1 << pfeng_hif_ids[netif->tx_chnl[ring]]);
+	}
+
+	/* Only traffic of this netdev, as the EMAC logif does */
+	if (!ret)
+		ret = pfe_log_if_add_match_rule(logif, IF_MATCH_DMAC, (void *)netif->netdev->dev_addr, 6U);
+	if (!ret && (prog->m_rules & IF_MATCH_TYPE_IPV4))
+		ret = pfe_log_if_add_match_rule(logif, IF_MATCH_TYPE_IPV4, NULL, 0U);
+	if (!ret && (prog->m_rules & IF_MATCH_TYPE_IPV6))
+		ret = pfe_log_if_add_match_rule(logif, IF_MATCH_TYPE_IPV6, NULL, 0U);
+	if (!ret && (prog->m_rules & IF_MATCH_ETHTYPE))
+		ret = pfe_log_if_add_match_rule(logif, IF_MATCH_ETHTYPE, &prog->ethtype, sizeof(prog->ethtype));
+	if (!ret)
+		ret = pfe_log_if_add_match_rule(logif, IF_MATCH_FP0, &fp_table, sizeof(fp_table));
+	if (!ret)
+		ret = pfe_log_if_enable(logif);
+	if (ret) {
+		if (EOK == pfe_platform_unregister_log_if(priv->pfe_platform, logif))
+			pfe_log_if_destroy(logif);
+		return NULL;
+	}
+
+	return logif;
+}
+
+static void pfeng_ntuple_logif_destroy(struct pfeng_netif *netif, struct pfeng_ntuple_rule *rule)
+{
+	struct pfeng_priv *priv = netif->priv;
+
+	if (rule->logif) {
+		pfe_log_if_disable(rule->logif);
+		if (EOK != pfe_platform_unregister_log_if(priv->pfe_platform, rule->logif))
+			netdev_warn(netif->netdev, "Can't unregister ntuple %u Logif\n", rule->fs.location);
+		else
+			pfe_log_if_destroy(rule->logif);
+		rule->logif = NULL;
+	}
+
+	if (rule->fp_table) {
+		pfe_fp_destroy_table(priv->pfe_platform->classifier, rule->fp_table);
+		rule->fp_table = 0;
+	}
+}
+
+static void pfeng_ntuple_release(struct pfeng_netif *netif)
+{
+	u32 i;
+
+	for (i = 0; i < PFENG_NTUPLE_RULES; i++)
+		pfeng_ntuple_logif_destroy(netif, &netif->ntuple.rule[i]);
+}
+
+/* Recreate logifs of all rules, the last created is matched first, ntuple.lock held */
+static int pfeng_ntuple_apply(struct pfeng_netif *netif)
+{
+	struct pfeng_ntuple_prog *prog;
+	struct pfeng_ntuple_rule *rule;
+	int i, ret = 0;
+
+	pfeng_ntuple_release(netif);
+
+	prog = kzalloc(sizeof(*prog), GFP_KERNEL);
+	if (!prog)
+		return -ENOMEM;
+
+	for (i = PFENG_NTUPLE_RULES - 1; i >= 0; i--) {
+		rule = &netif->ntuple.rule[i];
+		if (!rule->used)
+			continue;
+
+		ret = pfeng_ntuple_compile(&rule->fs, prog);
+		if (ret)
+			break;
+
+		rule->fp_table = pfeng_ntuple_create_table(netif, prog);
+		if (!rule->fp_table) {
+			netdev_err(netif->netdev, "No DMEM for ntuple %u table\n", i);
+			ret = -ENOMEM;
+			break;
+		}
+
+		rule->logif = pfeng_ntuple_logif_create(netif, &rule->fs, prog, rule->fp_table);
+		if (!rule->logif) {
+			netdev_err(netif->netdev, "ntuple %u Logif can't be created\n", i);
+			ret = -EINVAL;
+			break;
+		}
+	}
+
+	kfree(prog);
+
+	if (ret)
+		pfeng_ntuple_release(netif);
+
+	return ret;
+}
+
+static bool pfeng_ntuple_supported(struct pfeng_netif *netif)
+{
+	/* Logifs are matched in FlexibleRouter mode only */
+	return !netif->cfg->tx_inject && is_valid_ether_addr(netif->netdev->dev_addr);
+}
+
+/**
+ * @brief	Initialize empty ntuple rule table
+ * @param[in]	netif Net interface instance
+ */
+void pfeng_ntuple_init(struct pfeng_netif *netif)
+{
+	mutex_init(&netif->ntuple.lock);
+	memset(netif->ntuple.rule, 0, sizeof(netif->ntuple.rule));
+	netif->ntuple.active = false;
+}
+
+/**
+ * @brief	Create logifs of the ntuple rules
+ * @details	Called once the platform interfaces are set, after RSS start
+ *		so the rules are matched first.
+ * @param[in]	netif Net interface instance
+ * @return	0 OK
+ */
+int pfeng_ntuple_start(struct pfeng_netif *netif)
+{
+	int ret;
+
+	if (!pfeng_ntuple_supported(netif))
+		return 0;
+
+	mutex_lock(&netif->ntuple.lock);
+	ret = pfeng_ntuple_apply(netif);
+	if (!ret)
+		netif->ntuple.active = true;
+	mutex_unlock(&netif->ntuple.lock);
+
+	return ret;
+}
+
+/**
+ * @brief	Remove logifs of the ntuple rules
+ * @param[in]	netif Net interface instance
+ * @param[in]	release False when platform is going down (suspend) and
+ *		releases all logifs and DMEM by itself
+ */
+void pfeng_ntuple_stop(struct pfeng_netif *netif, bool release)
+{
+	u32 i;
+
+	mutex_lock(&netif->ntuple.lock);
+	for (i = 0; i < PFENG_NTUPLE_RULES; i++) {
+		if (release) {
+			pfeng_ntuple_logif_destroy(netif, &netif->ntuple.rule[i]);
+		} else {
+			netif->ntuple.rule[i].logif = NULL;
+			netif->ntuple.rule[i].fp_table = 0;
+		}
+	}
+	netif->ntuple.active = false;
+	mutex_unlock(&netif->ntuple.lock);
+}
+
+/**
+ * @brief	Follow the netdev MAC address change
+ * @param[in]	netif Net interface instance
+ * @return	0 OK
+ */
+int pfeng_ntuple_set_mac(struct pfeng_netif *netif)
+{
+	u32 i;
+	int ret = 0;
+
+	mutex_lock(&netif->ntuple.lock);
+	for (i = 0; i < PFENG_NTUPLE_RULES && !ret; i++)
+		if (netif->ntuple.rule[i].logif)
+			ret = pfe_log_if_add_match_rule(netif->ntuple.rule[i].logif, IF_MATCH_DMAC,
+							(void *)netif->netdev->dev_addr, 6U);
+	mutex_unlock(&netif->ntuple.lock);
+
+	return -ret;
+}
+
+u32 pfeng_ntuple_get_count(struct pfeng_netif *netif)
+{
+	u32 i, cnt = 0;
+
+	mutex_lock(&netif->ntuple.lock);
+	for (i = 0; i < PFENG_NTUPLE_RULES; i++)
+		if (netif->ntuple.rule[i].used)
+			cnt++;
+	mutex_unlock(&netif->ntuple.lock);
+
+	return cnt;
+}
+
+/* Number of RX queues the rules steer to */
+u32 pfeng_ntuple_get_rings(struct pfeng_netif *netif)
+{
+	struct pfeng_ntuple_rule *rule;
+	u32 i, rings = 0;
+
+	mutex_lock(&netif->ntuple.lock);
+	for (i = 0; i < PFENG_NTUPLE_RULES; i++) {
+		rule = &netif->ntuple.rule[i];
+		if (!rule->used || rule->fs.ring_cookie == RX_CLS_FLOW_DISC)
+			continue;
+
+		rings = max_t(u32, rings, ethtool_get_flow_spec_ring(rule->fs.ring_cookie) + 1);
+	}
+	mutex_unlock(&netif->ntuple.lock);
+
+	return rings;
+}
+
+int pfeng_ntuple_get_rule(struct pfeng_netif *netif, struct ethtool_rx_flow_spec *fs)
+{
+	int ret = -ENOENT;
+
+	if (fs->location >= PFENG_NTUPLE_RULES)
+		return -EINVAL;
+
+	mutex_lock(&netif->ntuple.lock);
+	if (netif->ntuple.rule[fs->location].used) {
+		*fs = netif->ntuple.rule[fs->location].fs;
+		ret = 0;
+	}
+	mutex_unlock(&netif->ntuple.lock);
+
+	return ret;
+}
+
+int pfeng_ntuple_get_all(struct pfeng_netif *netif, u32 *rule_locs, u32 *cnt)
+{
+	u32 i, n = 0;
+	int ret = 0;
+
+	mutex_lock(&netif->ntuple.lock);
+	for (i = 0; i < PFENG_NTUPLE_RULES; i++) {
+		if (!netif->ntuple.rule[i].used)
+			continue;
+		if (n == *cnt) {
+			ret = -EMSGSIZE;
+			break;
+		}
+		rule_locs[n++] = i;
+	}
+	mutex_unlock(&netif->ntuple.lock);
+
+	*cnt = n;
+
+	return ret;
+}
+
+/**
+ * @brief	Insert or replace ntuple rule
+ * @param[in]	netif Net interface instance
+ * @param[in]	fs Flow specification, location selects the rule
+ * @return	0 OK
+ */
+int pfeng_ntuple_add(struct pfeng_netif *netif, struct ethtool_rx_flow_spec *fs)
+{
+	struct pfeng_ntuple_rule *rule, old;
+	struct pfeng_ntuple_prog *prog;
+	int ret;
+
+	if (!pfeng_ntuple_supported(netif))
+		return -EOPNOTSUPP;
+
+	if (fs->location >= PFENG_NTUPLE_RULES)
+		return -EINVAL;
+
+	ret = pfeng_ntuple_check_action(netif, fs);
+	if (ret)
+		return ret;
+
+	/* Reject what can't be compiled before touching the running rules */
+	prog = kzalloc(sizeof(*prog), GFP_KERNEL);
+	if (!prog)
+		return -ENOMEM;
+	ret = pfeng_ntuple_compile(fs, prog);
+	kfree(prog);
+	if (ret) {
+		netdev_err(netif->netdev, "Unsupported ntuple rule: %d\n", ret);
+		return ret;
+	}
+
+	mutex_lock(&netif->ntuple.lock);
+	rule = &netif->ntuple.rule[fs->location];
+	old = *rule;
+	rule->fs = *fs;
+	rule->used = true;
+
+	if (netif->ntuple.active) {
+		ret = pfeng_ntuple_apply(netif);
+		if (ret) {
+			rule->fs = old.fs;
+			rule->used = old.used;
+			if (pfeng_ntuple_apply(netif))
+				netdev_err(netif->netdev, "ntuple rules are not applied\n");
+		}
+	}
+	mutex_unlock(&netif->ntuple.lock);
+
+	return ret;
+}
+
+int pfeng_ntuple_del(struct pfeng_netif *netif, u32 location)
+{
+	struct pfeng_ntuple_rule *rule;
+	int ret = 0;
+
+	if (location >= PFENG_NTUPLE_RULES)
+		return -EINVAL;
+
+	mutex_lock(&netif->ntuple.lock);
+	rule = &netif->ntuple.rule[location];
+	if (!rule->used) {
+		ret = -ENOENT;
+	} else {
+		/* Other rules keep their order */
+		pfeng_ntuple_logif_destroy(netif, rule);
+		rule->used = false;
+	}
+	mutex_unlock(&netif->ntuple.lock);
+
+	return ret;
+}
@@ -0,0 +1,402 @@
+/*
+ * Copyright 2021 NXP
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ *
+ */
+
+#include <linux/ethtool.h>
+#include <net/ipv6.h>
+
+#include "pfe_cfg.h"
+#include "oal.h"
+#include "pfe_platform.h"
+#include "pfe_fp.h"
+
+#include "pfeng.h"
+
+/*
+ * The firmware has no flow hash, so the receive side steering is built
+ * from the Flexible Parser. This is port-only steering: flow bucket is
+ * taken from the low bits of both L4 ports, IP addresses are not part
+ * of the key. Flows differing in addresses only share the bucket, and
+ * traffic to one well-known port is spread by the source port bits
+ * only (4 of 16 buckets). Each bucket is one ACCEPT rule in the FP table
+ * of the HIF channel the bucket is mapped to by the indirection table.
+ * IP fragments don't carry the ports (or the first one only), they are
+ * all pinned to the queue of bucket 0 by rules in front of the buckets.
+ * Every channel owning a bucket has own logif matching the netdev MAC
+ * and the table, all of them are placed in front of the EMAC logif,
+ * which keeps loadbalancing for the rest of the traffic.
+ */
+#define PFENG_RSS_PORT_MASK	(BIT(PFENG_RSS_PORT_BITS) - 1)
+#define PFENG_RSS_FRAG_RULES	4U
+
+static void pfeng_rss_frag_rules(bool pin, pfe_ct_fp_rule_t *rules)
+{
+	u8 action = pin ? FP_FL_ACCEPT : FP_FL_REJECT;
+
+	memset(rules, 0, PFENG_RSS_FRAG_RULES * sizeof(*rules));
+
+	/* IPv6 goes to its own check */
+	rules[0].data = oal_htonl(0x60000000U);
+	rules[0].mask = oal_htonl(0xf0000000U);
+	rules[0].next_idx = 3U;
+	rules[0].flags = FP_FL_L3_OFFSET;
+
+	/* Neither IPv4 nor IPv6, straight to the buckets */
+	rules[1].data = oal_htonl(0x40000000U);
+	rules[1].mask = oal_htonl(0xf0000000U);
+	rules[1].next_idx = PFENG_RSS_FRAG_RULES;
+	rules[1].flags = FP_FL_INVERT | FP_FL_L3_OFFSET;
+
+	/* IPv4 with MF flag or fragment offset set */
+	rules[2].data = oal_htonl(0U);
+	rules[2].mask = oal_htonl(0x00003fffU);
+	rules[2].offset = oal_htons(4U);
+	rules[2].next_idx = 0xffU;
+	rules[2].flags = action | FP_FL_INVERT | FP_FL_L3_OFFSET;
+
+	/*
+	 * IPv6 with fragment header as the next header. IPv4 which is not
+	 * a fragment gets here too, its byte 6 can't hold the value.
+	 */
+	rules[3].data = oal_htonl((u32)NEXTHDR_FRAGMENT << 8);
+	rules[3].mask = oal_htonl(0x0000ff00U);
+	rules[3].offset = oal_htons(4U);
+	rules[3].next_idx = 0xffU;
+	rules[3].flags = action | FP_FL_L3_OFFSET;
+}
+
+static void pfeng_rss_bucket_to_rule(u32 bucket, pfe_ct_fp_rule_t *rule)
+{
+	u32 sport = (bucket >> PFENG_RSS_PORT_BITS) & PFENG_RSS_PORT_MASK;
+	u32 dport = bucket & PFENG_RSS_PORT_MASK;
+
+	/* L4 header starts with source and destination port, network endian */
+	rule->data = oal_htonl((sport << 16) | dport);
+	rule->mask = oal_htonl((PFENG_RSS_PORT_MASK << 16) | PFENG_RSS_PORT_MASK);
+	rule->offset = oal_htons(0U);
+	rule->next_idx = 0xffU;
+	rule->flags = FP_FL_ACCEPT | FP_FL_L4_OFFSET;
+}
+
+static u32 pfeng_rss_queue_buckets(struct pfeng_netif *netif, u32 queue)
+{
+	u32 i, cnt = 0;
+
+	for (i = 0; i < PFENG_RSS_INDIR_SIZE; i++)
+		if (netif->rss.indir[i] == queue)
+			cnt++;
+
+	return cnt;
+}
+
+/* Write FP table with fragment rules and ACCEPT rules for all buckets of the RX queue */
+static u32 pfeng_rss_create_table(struct pfeng_netif *netif, u32 queue)
+{
+	pfe_class_t *class = netif->priv->pfe_platform->classifier;
+	pfe_ct_fp_rule_t frag[PFENG_RSS_FRAG_RULES];
+	pfe_ct_fp_rule_t rule;
+	u32 addr, i;
+	u8 cnt;
+
+	addr = pfe_fp_create_table(class, PFENG_RSS_FRAG_RULES + pfeng_rss_queue_buckets(netif, queue));
+	if (!addr)
+		return 0;
+
+	pfeng_rss_frag_rules(netif->rss.indir[0] == queue, frag);
+	for (cnt = 0; cnt < PFENG_RSS_FRAG_RULES; cnt++) {
+		if (!pfe_fp_table_write_rule(class, addr, &frag[cnt], cnt)) {
+			pfe_fp_destroy_table(class, addr);
+			return 0;
+		}
+	}
+
+	for (i = 0; i < PFENG_RSS_INDIR_SIZE; i++) {
+		if (netif->rss.indir[i] != queue)
+			continue;
+
+		pfeng_rss_bucket_to_rule(i, &rule);
+		if (!pfe_fp_table_write_rule(class, addr, &rule, cnt)) {
+			pfe_fp_destroy_table(class, addr);
+			return 0;
+		}
+		cnt++;
+	}
+
+	return addr;
+}
+
+static pfe_log_if_t *pfeng_rss_logif_create(struct pfeng_netif *netif, u32 queue, u32 table)
+{
+	struct pfeng_priv *priv = netif->priv;
+	pfe_phy_if_t *phyif_emac = priv->emac[netif->cfg->emac].phyif_emac;
+	PFE_PTR(pfe_ct_fp_table_t) fp_table = oal_htonl(table);
+	char name[IFNAMSIZ + 8];
+	pfe_log_if_t *logif;
+	int ret;
+
+	scnprintf(name, sizeof(name), "%srss%u", netif->cfg->name, queue);
+	logif = pfe_log_if_create(phyif_emac, name);
+	if (!logif)
+		return NULL;
+
+	ret = pfe_platform_register_log_if(priv->pfe_platform, logif);
+	if (ret) {
+		pfe_log_if_destroy(logif);
+		return NULL;
+	}
+
+	ret = pfe_log_if_set_egress_ifs(logif, 1 << pfeng_hif_ids[netif->tx_chnl[queue]]);
+	if (!ret)
+		ret = pfe_log_if_add_match_rule(logif, IF_MATCH_DMAC, (void *)netif->netdev->dev_addr, 6U);
+	if (!ret)
+		ret = pfe_log_if_add_match_rule(logif, IF_MATCH_FP0, &fp_table, sizeof(fp_table));
+	if (!ret)
+		ret = pfe_log_if_enable(logif);
+	if (ret) {
+		if (EOK == pfe_platform_unregister_log_if(priv->pfe_platform, logif))
+			pfe_log_if_destroy(logif);
+		return NULL;
+	}
+
+	return logif;
+}
+
+static void pfeng_rss_logif_destroy(struct pfeng_netif *netif, u32 queue)
+{
+	struct pfeng_priv *priv = netif->priv;
+	pfe_log_if_t *logif = netif->rss.logif[queue];
+
+	if (logif) {
+		pfe_log_if_disable(logif);
+		if (EOK != pfe_platform_unregister_log_if(priv->pfe_platform, logif))
+			netdev_warn(netif->netdev, "Can't unregister RSS%u Logif\n", queue);
+		else
+			pfe_log_if_destroy(logif);
+		netif->rss.logif[queue] = NULL;
+	}
+
+	/* The table can go only after no logif references it */
+	if (netif->rss.fp_table[queue]) {
+		pfe_fp_destroy_table(priv->pfe_platform->classifier, netif->rss.fp_table[queue]);
+		netif->rss.fp_table[queue] = 0;
+	}
+}
+
+/* Push the indirection table to the FP tables, rss.lock held */
+static int pfeng_rss_apply(struct pfeng_netif *netif)
+{
+	pfe_class_t *class = netif->priv->pfe_platform->classifier;
+	PFE_PTR(pfe_ct_fp_table_t) fp_table;
+	u32 q, addr;
+	int ret;
+
+	for (q = 0; q < netif->cfg->hifs; q++) {
+		/* Queue without buckets needs no logif */
+		if (!pfeng_rss_queue_buckets(netif, q)) {
+			pfeng_rss_logif_destroy(netif, q);
+			continue;
+		}
+
+		addr = pfeng_rss_create_table(netif, q);
+		if (!addr) {
+			netdev_err(netif->netdev, "No DMEM for RSS%u table\n", q);
+			return -ENOMEM;
+		}
+
+		if (!netif->rss.logif[q]) {
+			netif->rss.logif[q] = pfeng_rss_logif_create(netif, q, addr);
+			if (!netif->rss.logif[q]) {
+				netdev_err(netif->netdev, "RSS%u Logif can't be created\n", q);
+				pfe_fp_destroy_table(class, addr);
+				return -EINVAL;
+			}
+		} else {
+			/* Switch the logif to the new table, then drop the old one */
+			fp_table = oal_htonl(addr);
+			ret = pfe_log_if_add_match_rule(netif->rss.logif[q], IF_MATCH_FP0, &fp_table, sizeof(fp_table));
+			if (ret) {
+				netdev_err(netif->netdev, "Can't update RSS%u table: %d\n", q, ret);
+				pfe_fp_destroy_table(class, addr);
+				return -ret;
+			}
+			pfe_fp_destroy_table(class, netif->rss.fp_table[q]);
+		}
+		netif->rss.fp_table[q] = addr;
+	}
+
+	return 0;
+}
+
+static bool pfeng_rss_supported(struct pfeng_netif *netif)
+{
+	return netif->cfg->hifs > 1 && !netif->cfg->tx_inject &&
+	       is_valid_ether_addr(netif->netdev->dev_addr);
+}
+
+/**
+ * @brief	Set default indirection table
+ * @param[in]	netif Net interface instance
+ */
+void pfeng_rss_init(struct pfeng_netif *netif)
+{
+	u32 i;
+
+	mutex_init(&netif->rss.lock);
+	netif->rss.active = false;
+
+	for (i = 0; i < PFENG_RSS_INDIR_SIZE; i++)
+		netif->rss.indir[i] = ethtool_rxfh_indir_default(i, netif->cfg->hifs);
+}
+
+/**
+ * @brief	Create the RSS logifs on top of EMAC logif
+ * @details	Called once the platform interfaces are set, the indirection
+ *		table configured before (ethtool or suspend) is restored.
+ * @param[in]	netif Net interface instance
+ * @return	0 OK
+ */
+int pfeng_rss_start(struct pfeng_netif *netif)
+{
+	u32 q;
+	int ret;
+
+	if (!pfeng_rss_supported(netif))
+		return 0;
+
+	mutex_lock(&netif->rss.lock);
+	ret = pfeng_rss_apply(netif);
+	if (ret)
+		for (q = 0; q < netif->cfg->hifs; q++)
+			pfeng_rss_logif_destroy(netif, q);
+	else
+		netif->rss.active = true;
+	mutex_unlock(&netif->rss.lock);
+
+	return ret;
+}
+
+/**
+ * @brief	Remove the RSS logifs
+ * @param[in]	netif Net interface instance
+ * @param[in]	release False when platform is going down (suspend) and
+ *		releases all logifs and DMEM by itself
+ */
+void pfeng_rss_stop(struct pfeng_netif *netif, bool release)
+{
+	u32 q;
+
+	mutex_lock(&netif->rss.lock);
+	for (q = 0; q < PFENG_PFE_HIF_CHANNELS; q++) {
+		if (release) {
+			pfeng_rss_logif_destroy(netif, q);
+		} else {
+			netif->rss.logif[q] = NULL;
+			netif->rss.fp_table[q] = 0;
+		}
+	}
+	netif->rss.active = false;
+	mutex_unlock(&netif->rss.lock);
+}
+
+/**
+ * @brief	Follow the netdev MAC address change
+ * @param[in]	netif Net interface instance
+ * @return	0 OK
+ */
+int pfeng_rss_set_mac(struct pfeng_netif *netif)
+{
+	u32 q;
+	int ret = 0;
+
+	mutex_lock(&netif->rss.lock);
+	for (q = 0; q < PFENG_PFE_HIF_CHANNELS && !ret; q++)
+		if (netif->rss.logif[q])
+			ret = pfe_log_if_add_match_rule(netif->rss.logif[q], IF_MATCH_DMAC,
+							(void *)netif->netdev->dev_addr, 6U);
+	mutex_unlock(&netif->rss.lock);
+
+	return -ret;
+}
+
+u32 pfeng_rss_get_indir_size(struct pfeng_netif *netif)
+{
+	return pfeng_rss_supported(netif) ? PFENG_RSS_INDIR_SIZE : 0;
+}
+
+void pfeng_rss_get_indir(struct pfeng_netif *netif, u32 *indir)
+{
+	mutex_lock(&netif->rss.lock);
+	memcpy(indir, netif->rss.indir, sizeof(netif->rss.indir));
+	mutex_unlock(&netif->rss.lock);
+}
+
+/**
+ * @brief	Fit the indirection table to new number of RX queues
+ * @details	Table set by user is kept and has to point to the remaining
+ *		queues only, the default one is spread over all of them.
+ *		Applied by the following pfeng_rss_start().
+ * @param[in]	netif Net interface instance
+ * @param[in]	queues New number of RX queues
+ * @return	0 OK
+ */
+int pfeng_rss_set_queues(struct pfeng_netif *netif, u32 queues)
+{
+	u32 i;
+	int ret = 0;
+
+	mutex_lock(&netif->rss.lock);
+	if (netif_is_rxfh_configured(netif->netdev)) {
+		for (i = 0; i < PFENG_RSS_INDIR_SIZE; i++)
+			if (netif->rss.indir[i] >= queues) {
+				ret = -EINVAL;
+				break;
+			}
+	} else {
+		for (i = 0; i < PFENG_RSS_INDIR_SIZE; i++)
+			netif->rss.indir[i] = ethtool_rxfh_indir_default(i, queues);
+	}
+	mutex_unlock(&netif->rss.lock);
+
+	return ret;
+}
+
+/**
+ * @brief	Set new indirection table
+ * @param[in]	netif Net interface instance
+ * @param[in]	indir PFENG_RSS_INDIR_SIZE entries of RX queue indexes
+ * @return	0 OK
+ */
+int pfeng_rss_set_indir(struct pfeng_netif *netif, const u32 *indir)
+{
+	u32 old[PFENG_RSS_INDIR_SIZE];
+	u32 i;
+	int ret = 0;
+
+	if (!pfeng_rss_supported(netif))
+		return -EOPNOTSUPP;
+
+	for (i = 0; i < PFENG_RSS_INDIR_SIZE; i++)
+		if (indir[i] >= netif->cfg->hifs)
+			return -EINVAL;
+
+	mutex_lock(&netif->rss.lock);
+	memcpy(old, netif->rss.indir, sizeof(old));
+	memcpy(netif->rss.indir, indir, sizeof(netif->rss.indir));
+
+	/* Logifs don't exist in suspend, new table is used on resume */
+	if (netif->rss.active) {
+		ret = pfeng_rss_apply(netif);
+		if (ret) {
+			/* Queues already switched go back to the old table */
+			memcpy(netif->rss.indir, old, sizeof(old));
+			if (pfeng_rss_apply(netif))
+				netdev_err(netif->netdev, "RSS tables are inconsistent\n");
+		}
+	}
+	mutex_unlock(&netif->rss.lock);
+
+	return ret;
+}
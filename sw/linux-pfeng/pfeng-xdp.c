@@ -0,0 +1,330 @@
+/*
+ * Copyright 2021 NXP
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ *
+ */
+
+#include <linux/net.h>
+#include <linux/bpf_trace.h>
+#include <linux/version.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6,6,0)
+#include <net/page_pool/helpers.h>
+#else
+#include <net/page_pool.h>
+#endif
+
+#include "pfe_cfg.h"
+#include "oal.h"
+#include "pfe_platform.h"
+
+#include "pfeng.h"
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(5,10,0)
+#define xdp_convert_buff_to_frame	convert_to_xdp_frame
+#endif
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(5,6,0)
+#define xdp_do_flush			xdp_do_flush_map
+#endif
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(5,16,0)
+#define txq_trans_cond_update		txq_trans_update
+#endif
+
+static int pfeng_xdp_setup(struct pfeng_netif *netif, struct bpf_prog *prog, struct netlink_ext_ack *extack)
+{
+	struct bpf_prog *old_prog;
+
+	/* Jumbo frames span more RX buffers, XDP gets only the first one */
+	if (prog && netif->netdev->mtu > PFENG_XDP_MAX_MTU) {
+		NL_SET_ERR_MSG_MOD(extack, "MTU too large for XDP");
+		return -EOPNOTSUPP;
+	}
+
+	/* RX buffers are always XDP ready, no need to restart the HIF channels */
+	old_prog = xchg(&netif->xdp_prog, prog);
+	if (old_prog)
+		bpf_prog_put(old_prog);
+
+	return 0;
+}
+
+/**
+ * @brief	The ndo_bpf callback
+ * @param[in]	netdev The net device
+ * @param[in]	bpf The BPF command
+ * @return	0 if OK, negative error code otherwise
+ */
+int pfeng_xdp_bpf(struct net_device *netdev, struct netdev_bpf *bpf)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+
+	switch (bpf->command) {
+	case XDP_SETUP_PROG:
+		return pfeng_xdp_setup(netif, bpf->prog, bpf->extack);
+#if LINUX_VERSION_CODE < KERNEL_VERSION(5,9,0)
+	case XDP_QUERY_PROG:
+		bpf->prog_id = netif->xdp_prog ? netif->xdp_prog->aux->id : 0;
+		return 0;
+#endif
+#ifdef PFENG_CFG_XSK_SUPPORT
+	case XDP_SETUP_XSK_POOL:
+		return pfeng_xsk_pool_setup(netif, bpf->xsk.pool, bpf->xsk.queue_id);
+#endif /* PFENG_CFG_XSK_SUPPORT */
+	default:
+		return -EINVAL;
+	}
+}
+
+/* Serialize with ndo_start_xmit on the queue and with other netifs of shared channel */
+static struct netdev_queue *pfeng_xdp_tx_lock(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl)
+{
+	struct netdev_queue *nq = netdev_get_tx_queue(netif->netdev, pfeng_hif_chnl_netif_txq(chnl, netif));
+
+	__netif_tx_lock(nq, smp_processor_id());
+	if (unlikely(pfeng_hif_chnl_tx_shared(chnl)))
+		spin_lock(&chnl->lock_tx);
+
+	return nq;
+}
+
+static void pfeng_xdp_tx_unlock(struct pfeng_hif_chnl *chnl, struct netdev_queue *nq)
+{
+	if (unlikely(pfeng_hif_chnl_tx_shared(chnl)))
+		spin_unlock(&chnl->lock_tx);
+
+	/* Keep TX watchdog quiet */
+	txq_trans_cond_update(nq);
+	__netif_tx_unlock(nq);
+}
+
+/**
+ * @brief	Enqueue XDP frame to HIF TX ring
+ * @details	The HIF TX header is placed into the frame headroom. Caller holds the TX lock.
+ * @param[in]	netif Net interface instance
+ * @param[in]	chnl The HIF channel
+ * @param[in]	xdpf The frame
+ * @param[in]	dma_map True for foreign frames, false for page_pool buffers of the channel
+ * @return	0 if OK, negative error code otherwise
+ */
+static int pfeng_xdp_xmit_frame(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, struct xdp_frame *xdpf, bool dma_map)
+{
+	void *data;
+	dma_addr_t des;
+	u32 len;
+	u8 flags;
+
+	if (unlikely(xdpf->headroom < PFENG_TX_PKT_HEADER_SIZE))
+		return -EOVERFLOW;
+
+	if (unlikely(!pfe_hif_chnl_can_accept_tx_num(chnl->priv, 1)))
+		return -EBUSY;
+
+	data = xdpf->data - PFENG_TX_PKT_HEADER_SIZE;
+	len = xdpf->len + PFENG_TX_PKT_HEADER_SIZE;
+
+#ifdef PFE_CFG_HIF_TX_FIFO_FIX
+	if (unlikely(FALSE == pfe_hif_chnl_can_accept_tx_data(chnl->priv, len)))
+		return -EBUSY;
+#endif /* PFE_CFG_HIF_TX_FIFO_FIX */
+
+	pfeng_netif_tx_hdr_init(netif, chnl, (pfe_ct_hif_tx_hdr_t *)data);
+
+	if (dma_map) {
+		des = dma_map_single(chnl->dev, data, len, DMA_TO_DEVICE);
+		if (unlikely(dma_mapping_error(chnl->dev, des)))
+			return -ENOMEM;
+		flags = PFENG_MAP_PKT_XDP_FRAME;
+	} else {
+		des = pfeng_bman_buf_sync_for_tx(chnl, data, len);
+		flags = PFENG_MAP_PKT_XDP_TX;
+	}
+
+	/* Record the mapping before the buffer is handed over */
+	pfeng_hif_chnl_txconf_put_map_xdp(chnl, data, des, len, xdpf, flags);
+
+	if (unlikely(EOK != pfe_hif_chnl_tx_enqueue(chnl->priv, (void *)des, data, len, true))) {
+		pfeng_hif_chnl_txconf_unroll_map_xdp(chnl);
+		return -EBUSY;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief	Enqueue XDP frame to HIF TX ring under the TX lock
+ * @details	The TX DMA is not started, see pfeng_xdp_finalize().
+ * @param[in]	netif Net interface instance
+ * @param[in]	chnl The HIF channel
+ * @param[in]	xdpf The frame
+ * @param[in]	dma_map True for foreign frames, false for page_pool buffers of the channel
+ * @return	0 if OK, negative error code otherwise
+ */
+int pfeng_xdp_tx_frame(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, struct xdp_frame *xdpf, bool dma_map)
+{
+	struct netdev_queue *nq;
+	int ret;
+
+	nq = pfeng_xdp_tx_lock(netif, chnl);
+	ret = pfeng_xdp_xmit_frame(netif, chnl, xdpf, dma_map);
+	pfeng_xdp_tx_unlock(chnl, nq);
+
+	return ret;
+}
+
+/* XDP_TX: send the buffer back through the receiving HIF channel */
+static int pfeng_xdp_tx_buff(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, struct xdp_buff *xdp)
+{
+	struct xdp_frame *xdpf = xdp_convert_buff_to_frame(xdp);
+
+	if (unlikely(!xdpf))
+		return -EOVERFLOW;
+
+	return pfeng_xdp_tx_frame(netif, chnl, xdpf, false);
+}
+
+/**
+ * @brief	Run XDP program on received frame
+ * @details	Called from RX NAPI. The buffer is released unless the verdict
+ *		is XDP_PASS.
+ * @param[in]	netif Net interface instance the frame is destined to
+ * @param[in]	chnl The receiving HIF channel
+ * @param[in]	prog The XDP program
+ * @param[in]	xdp The frame
+ * @return	PFENG_XDP_PASS or the action taken
+ */
+u32 pfeng_xdp_run(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, struct bpf_prog *prog, struct xdp_buff *xdp)
+{
+	u32 act;
+
+	act = bpf_prog_run_xdp(prog, xdp);
+	switch (act) {
+	case XDP_PASS:
+		return PFENG_XDP_PASS;
+	case XDP_TX:
+		if (unlikely(pfeng_xdp_tx_buff(netif, chnl, xdp)))
+			goto err;
+		return PFENG_XDP_TX;
+	case XDP_REDIRECT:
+		if (unlikely(xdp_do_redirect(netif->netdev, xdp, prog)))
+			goto err;
+		return PFENG_XDP_REDIRECT;
+	default:
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,17,0)
+		bpf_warn_invalid_xdp_action(netif->netdev, prog, act);
+#else
+		bpf_warn_invalid_xdp_action(act);
+#endif
+		/* fall through */
+	case XDP_ABORTED:
+err:
+		trace_xdp_exception(netif->netdev, prog, act);
+		/* fall through */
+	case XDP_DROP:
+		break;
+	}
+
+	pfeng_netif_rxq_stats_drop(netif, chnl);
+	pfeng_bman_free_buf(chnl, xdp->data);
+
+	return PFENG_XDP_CONSUMED;
+}
+
+/**
+ * @brief	Finish XDP actions of the RX poll
+ * @param[in]	chnl The HIF channel
+ * @param[in]	xdp_status Accumulated actions of the poll
+ */
+void pfeng_xdp_finalize(struct pfeng_hif_chnl *chnl, u32 xdp_status)
+{
+	if (xdp_status & PFENG_XDP_TX)
+		pfe_hif_chnl_tx_dma_start(chnl->priv);
+
+	if (xdp_status & PFENG_XDP_REDIRECT)
+		xdp_do_flush();
+}
+
+/**
+ * @brief	The ndo_xdp_xmit callback
+ * @details	Frames redirected from other devices are sent through the HIF
+ *		channel of the TX queue assigned to the current CPU.
+ * @param[in]	netdev The net device
+ * @param[in]	n Number of frames
+ * @param[in]	frames The frames
+ * @param[in]	flags XDP_XMIT_* flags
+ * @return	Number of sent frames, negative error code otherwise
+ */
+int pfeng_xdp_xmit(struct net_device *netdev, int n, struct xdp_frame **frames, u32 flags)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+	struct pfeng_hif_chnl *chnl;
+	struct netdev_queue *nq;
+	int i, sent;
+
+	if (unlikely(flags & ~XDP_XMIT_FLAGS_MASK))
+		return -EINVAL;
+
+	if (unlikely(!netif_running(netdev)))
+		return -ENETDOWN;
+
+	chnl = &netif->priv->hif_chnl[netif->tx_chnl[smp_processor_id() % netif->cfg->hifs]];
+	if (unlikely(chnl->status != PFENG_HIF_STATUS_RUNNING))
+		return -ENETDOWN;
+
+	nq = pfeng_xdp_tx_lock(netif, chnl);
+	/* Queue is stopped also while the channel is being reconfigured */
+	for (i = 0; i < n && !netif_xmit_stopped(nq); i++) {
+		if (pfeng_xdp_xmit_frame(netif, chnl, frames[i], true))
+			break;
+	}
+	pfeng_xdp_tx_unlock(chnl, nq);
+
+	if (flags & XDP_XMIT_FLUSH)
+		pfe_hif_chnl_tx_dma_start(chnl->priv);
+
+	sent = i;
+#if LINUX_VERSION_CODE < KERNEL_VERSION(5,13,0)
+	/* Driver owns the frames it could not send */
+	for (; i < n; i++)
+		xdp_return_frame_rx_napi(frames[i]);
+#endif
+
+	return sent;
+}
+
+/**
+ * @brief	Register XDP RX queue of netif served by HIF channel
+ * @param[in]	netif Net interface instance
+ * @param[in]	chnl The HIF channel
+ * @return	0 if OK, negative error code otherwise
+ */
+int pfeng_xdp_rxq_reg(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl)
+{
+	struct xdp_rxq_info *rxq = &netif->xdp_rxq[chnl->idx];
+	u16 queue = pfeng_hif_chnl_netif_txq(chnl, netif);
+	int ret;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,13,0)
+	ret = xdp_rxq_info_reg(rxq, netif->netdev, queue, chnl->napi.napi_id);
+#else
+	ret = xdp_rxq_info_reg(rxq, netif->netdev, queue);
+#endif
+	if (ret)
+		return ret;
+
+	/* RX buffers of all netifs on the channel come from the same page_pool */
+	ret = xdp_rxq_info_reg_mem_model(rxq, MEM_TYPE_PAGE_POOL, pfeng_bman_page_pool(chnl));
+	if (ret)
+		xdp_rxq_info_unreg(rxq);
+
+	return ret;
+}
+
+void pfeng_xdp_rxq_unreg(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl)
+{
+	struct xdp_rxq_info *rxq = &netif->xdp_rxq[chnl->idx];
+
+	if (xdp_rxq_info_is_reg(rxq))
+		xdp_rxq_info_unreg(rxq);
+}
@@ -0,0 +1,563 @@
+/*
+ * Copyright 2021 NXP
+ *
+ * SPDX-License-Identifier: GPL-2.0
+ *
+ */
+
+#include <linux/net.h>
+#include <linux/if_vlan.h>
+#include <linux/bpf_trace.h>
+#include <linux/version.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6,6,0)
+#include <net/page_pool/helpers.h>
+#else
+#include <net/page_pool.h>
+#endif
+
+#include "pfe_cfg.h"
+#include "oal.h"
+#include "pfe_platform.h"
+
+#include "pfeng.h"
+
+#ifdef PFENG_CFG_XSK_SUPPORT
+
+#if LINUX_VERSION_CODE < KERNEL_VERSION(5,16,0)
+#define txq_trans_cond_update		txq_trans_update
+#endif
+
+/* Frame is received in single buffer together with HIF header */
+static bool pfeng_xsk_mtu_fits(struct xsk_buff_pool *xsk_pool, int mtu)
+{
+	return xsk_pool_get_rx_frame_size(xsk_pool) >= PFENG_TX_PKT_HEADER_SIZE + mtu + VLAN_ETH_HLEN;
+}
+
+/**
+ * @brief	Switch RX buffers of HIF channel between page_pool and XSK pool
+ * @details	The channel is quiesced, RX ring drained and refilled from the new source.
+ * @param[in]	netif Net interface instance
+ * @param[in]	chnl The HIF channel
+ * @param[in]	xsk_pool The XSK pool or NULL to return to page_pool
+ * @return	0 if OK, negative error code otherwise
+ */
+static int pfeng_xsk_chnl_swap(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, struct xsk_buff_pool *xsk_pool)
+{
+	struct xdp_rxq_info *rxq = &netif->xdp_rxq[chnl->idx];
+	bool running = chnl->status == PFENG_HIF_STATUS_RUNNING;
+	int ret;
+
+	ret = pfeng_hif_chnl_quiesce(chnl);
+	if (ret)
+		goto resume;
+
+	/* Take all buffers from HW */
+	ret = pfe_hif_chnl_rx_drain(chnl->priv);
+	if (ret) {
+		dev_err(chnl->dev, "HIF%d RX ring drain failed: %d\n", chnl->idx, ret);
+		ret = -EIO;
+		goto resume;
+	}
+	pfeng_bman_rx_release_all(chnl);
+
+	xdp_rxq_info_unreg_mem_model(rxq);
+	if (xsk_pool) {
+		ret = xdp_rxq_info_reg_mem_model(rxq, MEM_TYPE_XSK_BUFF_POOL, NULL);
+		if (!ret)
+			xsk_pool_set_rxq_info(xsk_pool, rxq);
+	} else {
+		ret = xdp_rxq_info_reg_mem_model(rxq, MEM_TYPE_PAGE_POOL, pfeng_bman_page_pool(chnl));
+	}
+	if (ret) {
+		/* Keep the channel usable with its own buffers */
+		xsk_pool = NULL;
+		xdp_rxq_info_reg_mem_model(rxq, MEM_TYPE_PAGE_POOL, pfeng_bman_page_pool(chnl));
+	}
+
+	chnl->xsk_pool = xsk_pool;
+	chnl->xsk_netif = xsk_pool ? netif : NULL;
+	chnl->xsk_tx_hdr_idx = 0;
+
+	pfeng_hif_chnl_fill_rx_buffers(chnl);
+
+	/* Drain has re-enabled the DMA, keep it stopped until netif is up */
+	if (!running) {
+		pfe_hif_chnl_rx_disable(chnl->priv);
+		pfe_hif_chnl_tx_disable(chnl->priv);
+	}
+
+resume:
+	pfeng_hif_chnl_resume(chnl);
+
+	return ret;
+}
+
+static int pfeng_xsk_pool_enable(struct pfeng_netif *netif, struct xsk_buff_pool *xsk_pool, u16 queue)
+{
+	struct pfeng_hif_chnl *chnl;
+	u32 depth;
+	int ret;
+
+	if (queue >= netif->cfg->hifs)
+		return -EINVAL;
+
+	chnl = &netif->priv->hif_chnl[netif->tx_chnl[queue]];
+	/* Frames of other netifs or IHC can not land in UMEM */
+	if (chnl->cl_mode != PFENG_HIF_MODE_EXCLUSIVE || chnl->ihc) {
+		netdev_err(netif->netdev, "AF_XDP zero-copy requires exclusive HIF channel, HIF%d is shared\n", chnl->idx);
+		return -EOPNOTSUPP;
+	}
+
+	if (chnl->xsk_pool)
+		return -EBUSY;
+
+	if (!pfeng_xsk_mtu_fits(xsk_pool, netif->netdev->mtu)) {
+		netdev_err(netif->netdev, "AF_XDP frame size too small for MTU %d\n", netif->netdev->mtu);
+		return -EINVAL;
+	}
+
+	/* HIF TX header does not fit UMEM headroom, it is sent from separate buffer */
+	depth = pfe_hif_chnl_get_tx_fifo_depth(chnl->priv);
+	chnl->xsk_tx_hdr = dma_alloc_coherent(chnl->dev, depth * sizeof(*chnl->xsk_tx_hdr),
+					      &chnl->xsk_tx_hdr_dma, GFP_KERNEL);
+	if (!chnl->xsk_tx_hdr)
+		return -ENOMEM;
+
+	ret = xsk_pool_dma_map(xsk_pool, chnl->dev, 0);
+	if (ret)
+		goto err_free_hdr;
+
+	ret = pfeng_xsk_chnl_swap(netif, chnl, xsk_pool);
+	if (ret)
+		goto err_unmap;
+
+	netdev_info(netif->netdev, "AF_XDP zero-copy enabled on HIF%d\n", chnl->idx);
+
+	return 0;
+
+err_unmap:
+	xsk_pool_dma_unmap(xsk_pool, 0);
+err_free_hdr:
+	dma_free_coherent(chnl->dev, depth * sizeof(*chnl->xsk_tx_hdr), chnl->xsk_tx_hdr, chnl->xsk_tx_hdr_dma);
+	chnl->xsk_tx_hdr = NULL;
+
+	return ret;
+}
+
+static int pfeng_xsk_pool_disable(struct pfeng_netif *netif, u16 queue)
+{
+	struct xsk_buff_pool *xsk_pool;
+	struct pfeng_hif_chnl *chnl;
+	int ret;
+
+	if (queue >= netif->cfg->hifs)
+		return -EINVAL;
+
+	chnl = &netif->priv->hif_chnl[netif->tx_chnl[queue]];
+	xsk_pool = chnl->xsk_pool;
+	if (!xsk_pool)
+		return -EINVAL;
+
+	ret = pfeng_xsk_chnl_swap(netif, chnl, NULL);
+	if (ret)
+		netdev_warn(netif->netdev, "HIF%d did not stop cleanly: %d\n", chnl->idx, ret);
+
+	/* Return the descriptor which has never been sent */
+	if (chnl->xsk_tx_pend) {
+		xsk_tx_completed(xsk_pool, 1);
+		chnl->xsk_tx_pend = false;
+	}
+
+	/* Channel does not own UMEM buffers anymore */
+	chnl->xsk_pool = NULL;
+	chnl->xsk_netif = NULL;
+
+	xsk_pool_dma_unmap(xsk_pool, 0);
+	dma_free_coherent(chnl->dev, pfe_hif_chnl_get_tx_fifo_depth(chnl->priv) * sizeof(*chnl->xsk_tx_hdr),
+			  chnl->xsk_tx_hdr, chnl->xsk_tx_hdr_dma);
+	chnl->xsk_tx_hdr = NULL;
+
+	return 0;
+}
+
+/**
+ * @brief	Attach or detach XSK pool to TX/RX queue
+ * @param[in]	netif Net interface instance
+ * @param[in]	xsk_pool The XSK pool or NULL to detach
+ * @param[in]	queue The queue, served by HIF channel of the same index in hifmap
+ * @return	0 if OK, negative error code otherwise
+ */
+int pfeng_xsk_pool_setup(struct pfeng_netif *netif, struct xsk_buff_pool *xsk_pool, u16 queue)
+{
+	return xsk_pool ? pfeng_xsk_pool_enable(netif, xsk_pool, queue) :
+			  pfeng_xsk_pool_disable(netif, queue);
+}
+
+/**
+ * @brief	The ndo_xsk_wakeup callback
+ * @param[in]	netdev The net device
+ * @param[in]	queue The queue
+ * @param[in]	flags XDP_WAKEUP_* flags
+ * @return	0 if OK, negative error code otherwise
+ */
+int pfeng_xsk_wakeup(struct net_device *netdev, u32 queue, u32 flags)
+{
+	struct pfeng_netif *netif = netdev_priv(netdev);
+	struct pfeng_hif_chnl *chnl;
+
+	if (unlikely(!netif_running(netdev)))
+		return -ENETDOWN;
+
+	if (unlikely(queue >= netif->cfg->hifs))
+		return -EINVAL;
+
+	chnl = &netif->priv->hif_chnl[netif->tx_chnl[queue]];
+	if (unlikely(!chnl->xsk_pool))
+		return -ENXIO;
+
+	if (unlikely(chnl->status != PFENG_HIF_STATUS_RUNNING))
+		return -ENETDOWN;
+
+	if (flags & XDP_WAKEUP_RX)
+		napi_schedule(&chnl->napi);
+	if (flags & XDP_WAKEUP_TX)
+		napi_schedule(&chnl->napi_tx);
+
+	return 0;
+}
+
+/* Copy received data to new skb, UMEM buffer stays with the caller */
+static struct sk_buff *pfeng_xsk_copy_skb(struct pfeng_hif_chnl *chnl, void *data, u32 len)
+{
+	struct sk_buff *skb;
+
+	skb = napi_alloc_skb(&chnl->napi, len);
+	if (unlikely(!skb))
+		return NULL;
+
+	skb_put_data(skb, data, len);
+
+	return skb;
+}
+
+/* Copy XSK buffer to page based frame with headroom for HIF TX header */
+static struct xdp_frame *pfeng_xsk_copy_frame(struct xdp_buff *xdp)
+{
+	u32 len = xdp->data_end - xdp->data;
+	struct xdp_frame *xdpf;
+	struct page *page;
+	void *addr;
+
+	if (unlikely(sizeof(*xdpf) + XDP_PACKET_HEADROOM + len > PAGE_SIZE))
+		return NULL;
+
+	page = dev_alloc_page();
+	if (unlikely(!page))
+		return NULL;
+
+	addr = page_to_virt(page);
+	xdpf = addr;
+	memset(xdpf, 0, sizeof(*xdpf));
+
+	xdpf->data = addr + sizeof(*xdpf) + XDP_PACKET_HEADROOM;
+	memcpy(xdpf->data, xdp->data, len);
+	xdpf->len = len;
+	xdpf->headroom = XDP_PACKET_HEADROOM;
+	xdpf->frame_sz = PAGE_SIZE;
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6,14,0)
+	xdpf->mem_type = MEM_TYPE_PAGE_ORDER0;
+#else
+	xdpf->mem.type = MEM_TYPE_PAGE_ORDER0;
+#endif
+
+	return xdpf;
+}
+
+/**
+ * @brief	Run XDP program on received XSK buffer
+ * @details	XDP_PASS and XDP_TX copy the frame, the XSK buffer is returned
+ *		to the pool unless redirected.
+ * @return	PFENG_XDP_PASS or the action taken
+ */
+static u32 pfeng_xsk_run(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, struct bpf_prog *prog,
+			 struct xdp_buff *xdp, struct pfeng_rx_batch *batch)
+{
+	struct xdp_frame *xdpf;
+	struct sk_buff *skb;
+	u32 act;
+
+	act = bpf_prog_run_xdp(prog, xdp);
+	switch (act) {
+	case XDP_REDIRECT:
+		if (unlikely(xdp_do_redirect(netif->netdev, xdp, prog)))
+			goto err;
+		return PFENG_XDP_REDIRECT;
+	case XDP_PASS:
+		skb = pfeng_xsk_copy_skb(chnl, xdp->data, xdp->data_end - xdp->data);
+		xsk_buff_free(xdp);
+		if (unlikely(!skb)) {
+			pfeng_netif_rxq_stats_drop(netif, chnl);
+			return PFENG_XDP_CONSUMED;
+		}
+		pfeng_hif_chnl_rx_skb(chnl, netif, skb, batch);
+		return PFENG_XDP_PASS;
+	case XDP_TX:
+		/* UMEM buffer may not be recycled from TX confirmation, send a copy */
+		xdpf = pfeng_xsk_copy_frame(xdp);
+		if (unlikely(!xdpf))
+			goto err;
+		if (unlikely(pfeng_xdp_tx_frame(netif, chnl, xdpf, true))) {
+			xdp_return_frame(xdpf);
+			goto err;
+		}
+		xsk_buff_free(xdp);
+		return PFENG_XDP_TX;
+	default:
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,17,0)
+		bpf_warn_invalid_xdp_action(netif->netdev, prog, act);
+#else
+		bpf_warn_invalid_xdp_action(act);
+#endif
+		/* fall through */
+	case XDP_ABORTED:
+err:
+		trace_xdp_exception(netif->netdev, prog, act);
+		/* fall through */
+	case XDP_DROP:
+		break;
+	}
+
+	pfeng_netif_rxq_stats_drop(netif, chnl);
+	xsk_buff_free(xdp);
+
+	return PFENG_XDP_CONSUMED;
+}
+
+/**
+ * @brief	Check the MTU against frame size of the bound XSK pools
+ * @param[in]	netif Net interface instance
+ * @param[in]	mtu The new MTU
+ * @return	0 if OK, -EINVAL if the frames would not fit XSK RX buffers
+ */
+int pfeng_xsk_check_mtu(struct pfeng_netif *netif, int mtu)
+{
+	struct pfeng_hif_chnl *chnl;
+	u32 q;
+
+	for (q = 0; q < netif->cfg->hifs; q++) {
+		chnl = &netif->priv->hif_chnl[netif->tx_chnl[q]];
+		if (chnl->xsk_pool && !pfeng_xsk_mtu_fits(chnl->xsk_pool, mtu))
+			return -EINVAL;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief	Process receive of HIF channel in AF_XDP zero-copy mode
+ * @details	Frames without XDP program attached and time stamped frames
+ *		are copied to the stack.
+ * @param[in]	chnl The HIF channel
+ * @param[in]	limit The receive process limit
+ * @return	Number of received frames
+ */
+int pfeng_xsk_chnl_rx(struct pfeng_hif_chnl *chnl, int limit)
+{
+	struct xsk_buff_pool *xsk_pool = chnl->xsk_pool;
+	pfe_ct_hif_rx_hdr_t *hif_hdr;
+	struct pfeng_netif *netif;
+	struct bpf_prog *xdp_prog;
+	struct pfeng_rx_batch batch;
+	struct xdp_buff *xdp;
+	struct sk_buff *skb;
+	u32 len, xdp_act, xdp_status = 0;
+	bool lifm;
+	int done = 0;
+
+	pfeng_hif_chnl_rx_batch_init(&batch);
+
+	while (done < limit) {
+
+		xdp = pfeng_hif_chnl_receive_xsk(chnl, &len, &lifm);
+		if (unlikely(!xdp))
+			/* no more packets */
+			break;
+
+		/* Frame spanning more buffers does not fit XSK frame, drop all of them */
+		if (unlikely(chnl->rx_skb_discard || !lifm)) {
+			if (!chnl->rx_skb_discard)
+				dev_err_ratelimited(chnl->dev, "Frame spanning more RX buffers dropped\n");
+			xsk_buff_free(xdp);
+			chnl->rx_skb_discard = !lifm;
+			continue;
+		}
+
+		hif_hdr = (pfe_ct_hif_rx_hdr_t *)xdp->data;
+		hif_hdr->flags = (pfe_ct_hif_rx_flags_t)oal_ntohs(hif_hdr->flags);
+
+		netif = chnl->netifs[hif_hdr->i_phy_if];
+		if (unlikely(!netif)) {
+			dev_err(chnl->dev, "Packet for unconfigured PhyIf %d\n", hif_hdr->i_phy_if);
+			xsk_buff_free(xdp);
+			continue;
+		}
+
+		if (unlikely(hif_hdr->flags & HIF_RX_ETS)) {
+
+			skb = pfeng_xsk_copy_skb(chnl, xdp->data, len);
+			xsk_buff_free(xdp);
+			if (unlikely(!skb))
+				continue;
+
+			/* Get tx hw time stamp */
+			pfeng_hwts_get_tx_ts(netif, skb);
+			/* Skb has only time stamp report so consume it */
+			consume_skb(skb);
+
+			continue;
+		}
+
+		xdp_prog = READ_ONCE(netif->xdp_prog);
+		if (unlikely(!xdp_prog || (hif_hdr->flags & HIF_RX_TS))) {
+
+			skb = pfeng_xsk_copy_skb(chnl, xdp->data, len);
+			xsk_buff_free(xdp);
+			if (unlikely(!skb)) {
+				pfeng_netif_rxq_stats_drop(netif, chnl);
+				continue;
+			}
+
+			if (unlikely(hif_hdr->flags & HIF_RX_TS))
+				/* Get rx hw time stamp */
+				pfeng_hwts_skb_set_rx_ts(netif, skb);
+
+			/* Skip HIF header */
+			skb_pull(skb, PFENG_TX_PKT_HEADER_SIZE);
+
+			pfeng_hif_chnl_rx_skb(chnl, netif, skb, &batch);
+			done++;
+			continue;
+		}
+
+		/* Run XDP on the frame without HIF header */
+		xdp->data += PFENG_TX_PKT_HEADER_SIZE;
+		xdp->data_meta = xdp->data;
+
+		xdp_act = pfeng_xsk_run(netif, chnl, xdp_prog, xdp, &batch);
+		if (xdp_act != PFENG_XDP_PASS) {
+			xdp_status |= xdp_act;
+			pfeng_rx_batch_count(&batch, netif, len - PFENG_TX_PKT_HEADER_SIZE);
+		}
+
+		done++;
+	}
+
+	/* Flush XDP_TX and XDP_REDIRECT frames once per poll */
+	if (xdp_status)
+		pfeng_xdp_finalize(chnl, xdp_status);
+
+	pfeng_hif_chnl_rx_flush(chnl, &batch);
+
+	/* Take what the fill ring offers, user space is asked for more when the ring runs short */
+	if (pfeng_hif_chnl_fill_rx_buffers(chnl))
+		pfe_hif_chnl_rx_dma_start(chnl->priv);
+
+	if (xsk_uses_need_wakeup(xsk_pool)) {
+		if (pfe_hif_chnl_can_accept_rx_buf(chnl->priv))
+			xsk_set_rx_need_wakeup(xsk_pool);
+		else
+			xsk_clear_rx_need_wakeup(xsk_pool);
+	}
+
+	return done;
+}
+
+/**
+ * @brief	Send frames from XSK TX ring
+ * @details	Called from TX NAPI. Each frame takes two BDs, the HIF TX header
+ *		from the coherent header array and the UMEM frame.
+ * @param[in]	chnl The HIF channel in AF_XDP zero-copy mode
+ * @param[in]	budget Maximum number of frames to send
+ * @return	True if the XSK TX ring has been emptied
+ */
+bool pfeng_xsk_chnl_xmit(struct pfeng_hif_chnl *chnl, int budget)
+{
+	struct xsk_buff_pool *xsk_pool = chnl->xsk_pool;
+	struct pfeng_netif *netif = chnl->xsk_netif;
+	u32 depth = pfe_hif_chnl_get_tx_fifo_depth(chnl->priv);
+	pfe_ct_hif_tx_hdr_t *tx_hdr;
+	pfe_hif_ring_buf_t bufs[2];
+	struct netdev_queue *nq;
+	dma_addr_t des, hdr_des;
+	struct xdp_desc desc;
+	u32 idx;
+	int sent = 0, ret;
+
+	/* Ring is shared with the stack TX queue */
+	nq = netdev_get_tx_queue(netif->netdev, pfeng_hif_chnl_netif_txq(chnl, netif));
+	__netif_tx_lock(nq, smp_processor_id());
+
+	while (sent < budget && !netif_xmit_stopped(nq) &&
+	       pfe_hif_chnl_can_accept_tx_num(chnl->priv, 2)) {
+
+#ifdef PFE_CFG_HIF_TX_FIFO_FIX
+		if (unlikely(FALSE == pfe_hif_chnl_can_accept_tx_data(chnl->priv, PFENG_TX_PKT_HEADER_SIZE + xsk_pool_get_rx_frame_size(xsk_pool))))
+			break;
+#endif /* PFE_CFG_HIF_TX_FIFO_FIX */
+
+		/* Completion ring slot is reserved by peek, so the failed descriptor goes first */
+		if (unlikely(chnl->xsk_tx_pend)) {
+			desc = chnl->xsk_tx_desc;
+			chnl->xsk_tx_pend = false;
+		} else if (!xsk_tx_peek_desc(xsk_pool, &desc)) {
+			break;
+		}
+
+		des = xsk_buff_raw_get_dma(xsk_pool, desc.addr);
+		xsk_buff_raw_dma_sync_for_device(xsk_pool, des, desc.len);
+
+		idx = chnl->xsk_tx_hdr_idx++ & (depth - 1);
+		tx_hdr = &chnl->xsk_tx_hdr[idx];
+		hdr_des = chnl->xsk_tx_hdr_dma + idx * sizeof(*tx_hdr);
+		pfeng_netif_tx_hdr_init(netif, chnl, tx_hdr);
+
+		/* Record the mappings before the buffers are handed over */
+		pfeng_hif_chnl_txconf_put_map_xdp(chnl, tx_hdr, hdr_des, sizeof(*tx_hdr), NULL, PFENG_MAP_PKT_XSK_TX);
+		pfeng_hif_chnl_txconf_put_map_xdp(chnl, xsk_buff_raw_get_data(xsk_pool, desc.addr), des, desc.len, NULL, PFENG_MAP_PKT_XSK_TX);
+
+		bufs[0].buf_pa = (void *)hdr_des;
+		bufs[0].len = sizeof(*tx_hdr);
+		bufs[0].lifm = false;
+		bufs[1].buf_pa = (void *)des;
+		bufs[1].len = desc.len;
+		bufs[1].lifm = true;
+
+		ret = pfe_hif_chnl_tx_burst(chnl->priv, bufs, 2);
+		if (unlikely(EOK != ret)) {
+			net_err_ratelimited("%s: HIF channel tx failed. Packet dropped. Error %d\n", netif->netdev->name, ret);
+			pfeng_hif_chnl_txconf_unroll_map_xdp(chnl);
+			pfeng_hif_chnl_txconf_unroll_map_xdp(chnl);
+			chnl->xsk_tx_desc = desc;
+			chnl->xsk_tx_pend = true;
+			break;
+		}
+
+		sent++;
+	}
+
+	if (sent) {
+		/* Keep TX watchdog quiet */
+		txq_trans_cond_update(nq);
+		pfe_hif_chnl_tx_dma_start(chnl->priv);
+		xsk_tx_release(xsk_pool);
+	}
+
+	__netif_tx_unlock(nq);
+
+	if (xsk_uses_need_wakeup(xsk_pool))
+		xsk_set_tx_need_wakeup(xsk_pool);
+
+	return sent < budget;
+}
+
+#endif /* PFENG_CFG_XSK_SUPPORT */
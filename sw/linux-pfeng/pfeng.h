@@ -10,6 +10,7 @@
 
 #include <linux/version.h>
 #include <linux/etherdevice.h>
+#include <linux/if_vlan.h>
 #include <linux/netdevice.h>
 #include <linux/phy.h>
 #include <linux/module.h>
@@ -19,6 +20,19 @@
 #include <linux/phylink.h>
 #include <linux/kfifo.h>
 #include <linux/mutex.h>
+#include <linux/u64_stats_sync.h>
+#include <linux/bpf.h>
+#include <net/xdp.h>
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,10,0)
+/* AF_XDP zero-copy relies on the xsk_buff_pool API */
+#define PFENG_CFG_XSK_SUPPORT
+#include <net/xdp_sock_drv.h>
+#endif
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(5,3,0) && IS_ENABLED(CONFIG_DIMLIB)
+/* Adaptive RX interrupt moderation */
+#define PFENG_CFG_DIM_SUPPORT
+#include <linux/dim.h>
+#endif
 #if !defined(PFENG_CFG_LINUX_NO_SERDES_SUPPORT)
 #include <linux/pcs/fsl-s32gen1-xpcs.h>
 #include <linux/phy/phy.h>
@@ -85,23 +99,149 @@ enum {
 
 enum {
 	PFENG_MAP_PKT_NORMAL,
-	PFENG_MAP_PKT_IHC
+	PFENG_MAP_PKT_IHC,
+	PFENG_MAP_PKT_COPYBREAK,
+	PFENG_MAP_PKT_TX_HDR,
+	PFENG_MAP_PKT_XDP_TX,
+	PFENG_MAP_PKT_XDP_FRAME,
+	PFENG_MAP_PKT_XSK_TX
 };
 
+/* XDP verdict summary of RX poll */
+#define PFENG_XDP_PASS			0
+#define PFENG_XDP_CONSUMED		BIT(0)
+#define PFENG_XDP_TX			BIT(1)
+#define PFENG_XDP_REDIRECT		BIT(2)
+
 #define PFENG_TX_PKT_HEADER_SIZE	(sizeof(pfe_ct_hif_tx_hdr_t))
 
-/* skbs waiting for time stamp */
-struct pfeng_ts_skb {
-	struct list_head		list;
+/* Small frames are copied into pre-mapped bounce buffer together with TX header */
+#define PFENG_TX_COPYBREAK_BUF		256U
+#define PFENG_TX_COPYBREAK_MAX		(PFENG_TX_COPYBREAK_BUF - PFENG_TX_PKT_HEADER_SIZE)
+#define PFENG_TX_COPYBREAK_DEF		128U
+
+/* RX buffer layout */
+#define PFE_RXB_TRUESIZE	PAGE_SIZE /* one buffer per page_pool page */
+#define PFE_RXB_PAD		XDP_PACKET_HEADROOM /* room for XDP head adjust and xdp_frame */
+#define PFE_RXB_DMA_SIZE	(SKB_WITH_OVERHEAD(PFE_RXB_TRUESIZE) - PFE_RXB_PAD)
+
+/* Jumbo frames span more RX buffers, XDP needs the frame in the first one */
+#define PFENG_MAX_MTU		9000
+#define PFENG_XDP_MAX_MTU	(PFE_RXB_DMA_SIZE - sizeof(pfe_ct_hif_rx_hdr_t) - VLAN_ETH_HLEN)
+
+/* TX time stamp reference is 12-bit wide, slot is selected by its low bits */
+#define PFENG_HWTS_REF_MASK		0x0FFFU
+#define PFENG_HWTS_SLOTS		64U
+/* time stamp has to be available in less than 1ms but we will wait for 5ms */
+#define PFENG_HWTS_AGE_MS		5
+
+/* skb waiting for time stamp */
+struct pfeng_ts_slot {
 	struct sk_buff			*skb;
-	unsigned long			jif_enlisted;
+	ktime_t				enlisted;
 	u16				ref_num;
 };
 
-/* timestamp data */
-struct pfeng_tx_ts {
-	u16				ref_num;
-	struct skb_shared_hwtstamps	ts;
+/* TX time stamp counters, latency is from arrival of the time stamp report to delivery to the socket */
+struct pfeng_hwts_stats {
+	u64				tx_requested;
+	u64				tx_matched;
+	u64				tx_skipped;
+	u64				tx_unknown;
+	u64				tx_aged;
+	u64				tx_lat_max_ns;
+	u64				tx_lat_sum_ns;
+};
+
+/* per TX queue counters, updated under the TX queue lock */
+struct pfeng_txq_stats {
+	u64				packets;
+	u64				bytes;
+	u64				dropped;
+	u64				stopped;
+	/* drop reasons */
+	u64				chnl_down;
+	u64				overlimited;
+	u64				dma_map_failed;
+	/* frames sent from bounce buffer */
+	u64				copybreak;
+	struct u64_stats_sync		syncp;
+};
+
+/* per RX queue counters, updated from RX NAPI of the HIF channel */
+struct pfeng_rxq_stats {
+	u64				packets;
+	u64				bytes;
+	u64				dropped;
+	struct u64_stats_sync		syncp;
+};
+
+/* HIF channel buffer pool counters, see pfeng_bman_get_stats() */
+struct pfeng_bman_stats {
+	u64				rx_ring_used;
+	u64				tx_ring_used;
+	u64				rx_alloc_err;
+	/* batched RX refills and those left short of buffers */
+	u64				rx_refills;
+	u64				rx_refill_starved;
+	/* page_pool reuse hits (fast) and misses (slow), CONFIG_PAGE_POOL_STATS only */
+	u64				pp_alloc_fast;
+	u64				pp_alloc_slow;
+	u64				pp_recycle_cached;
+	u64				pp_recycle_ring;
+	u64				pp_recycle_released;
+};
+
+/* raw firmware and EMAC counters, all of them are 32-bit wide */
+struct pfeng_hw_stats_raw {
+	pfe_ct_phy_if_stats_t		phy_if;
+	pfe_ct_class_algo_stats_t	log_if;
+	pfe_emac_rmon_stats_t		mac;
+};
+
+#define PFENG_HW_STATS_NUM	(sizeof(struct pfeng_hw_stats_raw) / sizeof(u32))
+/* hardware counters are folded into 64-bit ones before they can wrap */
+#define PFENG_HW_STATS_PERIOD	(4 * HZ)
+
+struct pfeng_hw_stats {
+	struct mutex			lock;
+	struct delayed_work		work;
+	bool				enabled;
+	u32				last[PFENG_HW_STATS_NUM];
+	u64				acc[PFENG_HW_STATS_NUM];
+};
+
+/* RX flow steering, flow bucket is made of PFENG_RSS_PORT_BITS of both L4 ports */
+#define PFENG_RSS_PORT_BITS	2
+#define PFENG_RSS_INDIR_SIZE	BIT(2 * PFENG_RSS_PORT_BITS)
+
+struct pfeng_rss {
+	struct mutex			lock;
+	/* logifs exist only while platform interfaces are set */
+	bool				active;
+	/* RX queue for each flow bucket */
+	u32				indir[PFENG_RSS_INDIR_SIZE];
+	/* per RX queue logif and its FP table in DMEM */
+	pfe_log_if_t			*logif[PFENG_PFE_HIF_CHANNELS];
+	u32				fp_table[PFENG_PFE_HIF_CHANNELS];
+};
+
+/* ethtool ntuple rules, each is compiled into own logif and FP table */
+#define PFENG_NTUPLE_RULES	16
+#define PFENG_NTUPLE_FP_RULES	16
+
+struct pfeng_ntuple_rule {
+	struct ethtool_rx_flow_spec	fs;
+	bool				used;
+	pfe_log_if_t			*logif;
+	u32				fp_table;
+};
+
+struct pfeng_ntuple {
+	struct mutex			lock;
+	/* logifs exist only while platform interfaces are set */
+	bool				active;
+	struct pfeng_ntuple_rule	rule[PFENG_NTUPLE_RULES];
 };
 
 /* config option for ethernet@ node */
@@ -131,16 +271,33 @@ struct pfeng_netif {
 	bool				slave_netif_inited;
 #endif /* PFE_CFG_PFE_SLAVE */
 
-	struct work_struct		tx_conf_work;
+	/* TX queue to HIF channel map and per queue stats */
+	u8				tx_chnl[PFENG_PFE_HIF_CHANNELS];
+	struct pfeng_txq_stats		txq_stats[PFENG_PFE_HIF_CHANNELS];
+	struct pfeng_rxq_stats		rxq_stats[PFENG_PFE_HIF_CHANNELS];
+	/* frames for TX queue without HIF channel */
+	atomic64_t			tx_map_chnl_failed;
+	/* frames up to this length are sent by copy, see ETHTOOL_TX_COPYBREAK */
+	u32				tx_copybreak;
+	/* accumulated firmware and EMAC counters */
+	struct pfeng_hw_stats		hw_stats;
+	/* RX flow steering, MASTER only */
+	struct pfeng_rss		rss;
+	struct pfeng_ntuple		ntuple;
+	/* XDP */
+	struct bpf_prog			*xdp_prog;
+	struct xdp_rxq_info		xdp_rxq[PFENG_PFE_HIF_CHANNELS];
 	/* PTP/Time stamping*/
 	struct ptp_clock_info           ptp_ops;
 	struct ptp_clock                *ptp_clock;
 	struct hwtstamp_config          tshw_cfg;
-	DECLARE_KFIFO_PTR(ts_skb_fifo, struct pfeng_ts_skb);
-	DECLARE_KFIFO_PTR(ts_tx_fifo, struct pfeng_tx_ts);
-	struct work_struct              ts_tx_work;
-	struct list_head                ts_skb_list;
-	uint16_t                        ts_ref_num;
+	/* TX time stamp requests, slots of [ts_tail, ts_head) may be pending */
+	spinlock_t			ts_lock;
+	struct pfeng_ts_slot		*ts_slots;
+	u32				ts_head;
+	u32				ts_tail;
+	struct pfeng_hwts_stats		ts_stats;
+	struct delayed_work		ts_age_work;
 	bool				ts_work_on;
 };
 
@@ -162,11 +319,13 @@ struct pfe_hif_drv_tag
 };
 #endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
 
+struct seq_file;
 struct pfeng_rx_chnl_pool;
 struct pfeng_tx_chnl_pool;
 struct pfeng_hif_chnl {
 	struct napi_struct		napi ____cacheline_aligned_in_smp;
-	struct mutex			lock_tx;
+	struct napi_struct		napi_tx ____cacheline_aligned_in_smp;
+	spinlock_t			lock_tx;
 	struct net_device		dummy_netdev;
 	struct device			*dev;
 	pfe_hif_chnl_t			*priv;
@@ -177,6 +336,10 @@ struct pfeng_hif_chnl {
 	u8				idx;
 	u8				netif_q_idx;
 	u32				features;
+	u32				cycles_per_usec;
+	/* ring lengths set by ethtool, kept over suspend, 0 for default */
+	u32				rx_ring_len;
+	u32				tx_ring_len;
 
 	struct pfeng_netif		*netifs[HIF_CLIENTS_MAX];
 
@@ -191,10 +354,82 @@ struct pfeng_hif_chnl {
 		struct pfeng_tx_chnl_pool	*tx_pool;
 	} bman;
 
+	/* frame spanning more RX buffers, kept over polls until LIFM */
+	struct sk_buff			*rx_skb;
+	struct pfeng_netif		*rx_skb_netif;
+	bool				rx_skb_discard;
+
 	pfe_phy_if_t			*phyif_hif;
 	pfe_log_if_t			*logif_hif;
+
+#ifdef PFENG_CFG_DIM_SUPPORT
+	/* Adaptive RX interrupt moderation */
+	struct dim			rx_dim;
+	bool				rx_dim_en;
+	u16				rx_dim_events;
+	u64				rx_dim_pkts;
+	u64				rx_dim_bytes;
+#endif /* PFENG_CFG_DIM_SUPPORT */
+
+#ifdef PFENG_CFG_XSK_SUPPORT
+	/* AF_XDP zero-copy, exclusive channel only */
+	struct xsk_buff_pool		*xsk_pool;
+	struct pfeng_netif		*xsk_netif;
+	pfe_ct_hif_tx_hdr_t		*xsk_tx_hdr;
+	dma_addr_t			xsk_tx_hdr_dma;
+	u32				xsk_tx_hdr_idx;
+	/* descriptor taken from XSK TX ring which failed to enqueue */
+	struct xdp_desc			xsk_tx_desc;
+	bool				xsk_tx_pend;
+#endif /* PFENG_CFG_XSK_SUPPORT */
 };
 
+/* RX frames and counters collected during one NAPI poll */
+struct pfeng_rx_batch {
+	struct list_head		gro_list;
+	struct list_head		list;
+	u32				pkts[HIF_CLIENTS_MAX];
+	u32				bytes[HIF_CLIENTS_MAX];
+};
+
+/* Account frame consumed during the poll, indexed the same way as chnl->netifs */
+static inline void pfeng_rx_batch_count(struct pfeng_rx_batch *batch, struct pfeng_netif *netif, u32 len)
+{
+	batch->pkts[netif->cfg->emac]++;
+	batch->bytes[netif->cfg->emac] += len;
+}
+
+/* TX ring of shared or IHC channel is accessed by several producers */
+static inline bool pfeng_hif_chnl_tx_shared(struct pfeng_hif_chnl *chnl)
+{
+#ifndef PFE_CFG_MULTI_INSTANCE_SUPPORT
+	return chnl->cl_mode == PFENG_HIF_MODE_SHARED;
+#else
+	return (chnl->cl_mode == PFENG_HIF_MODE_SHARED) || chnl->ihc;
+#endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
+}
+
+/* TX queue N of netif is served by N-th HIF channel in hifmap */
+static inline u16 pfeng_hif_chnl_netif_txq(struct pfeng_hif_chnl *chnl, struct pfeng_netif *netif)
+{
+	return hweight32(netif->cfg->hifmap & (BIT(chnl->idx) - 1));
+}
+
+/* Counters of netif RX queue served by the HIF channel */
+static inline struct pfeng_rxq_stats *pfeng_netif_rxq_stats(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl)
+{
+	return &netif->rxq_stats[pfeng_hif_chnl_netif_txq(chnl, netif)];
+}
+
+static inline void pfeng_netif_rxq_stats_drop(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl)
+{
+	struct pfeng_rxq_stats *stats = pfeng_netif_rxq_stats(netif, chnl);
+
+	u64_stats_update_begin(&stats->syncp);
+	stats->dropped++;
+	u64_stats_update_end(&stats->syncp);
+}
+
 struct pfeng_emac {
 	struct clk			*tx_clk;
 	struct clk			*rx_clk;
@@ -281,11 +516,20 @@ int pfeng_mdio_resume(struct pfeng_priv *priv);
 /* hif */
 int pfeng_hif_create(struct pfeng_priv *priv);
 void pfeng_hif_remove(struct pfeng_priv *priv);
-struct sk_buff *pfeng_hif_chnl_receive_pkt(struct pfeng_hif_chnl *chnl, uint32_t queue);
 int pfeng_hif_chnl_event_handler(pfe_hif_drv_client_t *client, void *data, uint32_t event, uint32_t qno);
 int pfe_hif_drv_ihc_put_pkt(pfe_hif_drv_client_t *client, void *data, uint32_t len, void *ref);
 int pfe_hif_drv_ihc_put_conf(pfe_hif_drv_client_t *client);
 int pfeng_hif_chnl_start(struct pfeng_hif_chnl *chnl);
+int pfeng_hif_chnl_quiesce(struct pfeng_hif_chnl *chnl);
+void pfeng_hif_chnl_resume(struct pfeng_hif_chnl *chnl);
+int pfeng_hif_chnl_set_ring_len(struct pfeng_hif_chnl *chnl, u32 rx_len, u32 tx_len);
+void pfeng_hif_chnl_rx_batch_init(struct pfeng_rx_batch *batch);
+void pfeng_hif_chnl_rx_skb(struct pfeng_hif_chnl *chnl, struct pfeng_netif *netif, struct sk_buff *skb, struct pfeng_rx_batch *batch);
+void pfeng_hif_chnl_rx_flush(struct pfeng_hif_chnl *chnl, struct pfeng_rx_batch *batch);
+u16 pfeng_hif_chnl_tx_wake_thresh(struct pfeng_hif_chnl *chnl);
+#ifdef PFENG_CFG_DIM_SUPPORT
+void pfeng_hif_chnl_rx_dim_enable(struct pfeng_hif_chnl *chnl, bool enable);
+#endif /* PFENG_CFG_DIM_SUPPORT */
 #ifdef PFE_CFG_MULTI_INSTANCE_SUPPORT
 void pfeng_ihc_tx_work_handler(struct work_struct *work);
 #endif /* PFE_CFG_MULTI_INSTANCE_SUPPORT */
@@ -293,20 +537,64 @@ void pfeng_ihc_tx_work_handler(struct work_struct *work);
 /* bman */
 int pfeng_bman_pool_create(struct pfeng_hif_chnl *chnl);
 void pfeng_bman_pool_destroy(struct pfeng_hif_chnl *chnl);
+int pfeng_bman_pool_resize(struct pfeng_hif_chnl *chnl, u32 rx_depth, u32 tx_depth);
 int pfeng_hif_chnl_fill_rx_buffers(struct pfeng_hif_chnl *chnl);
+int pfeng_hif_chnl_refill_rx_buffers(struct pfeng_hif_chnl *chnl);
+void *pfeng_hif_chnl_receive_buf(struct pfeng_hif_chnl *chnl, u32 *len, bool *lifm);
+struct sk_buff *pfeng_bman_build_skb(struct pfeng_hif_chnl *chnl, void *data, u32 len);
+int pfeng_bman_skb_add_frag(struct pfeng_hif_chnl *chnl, struct sk_buff *skb, void *data, u32 len);
+void pfeng_bman_free_buf(struct pfeng_hif_chnl *chnl, void *data);
+void pfeng_bman_xdp_buff_init(struct pfeng_hif_chnl *chnl, struct xdp_buff *xdp, void *buf, u32 len, struct xdp_rxq_info *rxq);
+dma_addr_t pfeng_bman_buf_sync_for_tx(struct pfeng_hif_chnl *chnl, void *data, u32 len);
+struct page_pool *pfeng_bman_page_pool(struct pfeng_hif_chnl *chnl);
+void pfeng_bman_rx_release_all(struct pfeng_hif_chnl *chnl);
+#ifdef PFENG_CFG_XSK_SUPPORT
+struct xdp_buff *pfeng_hif_chnl_receive_xsk(struct pfeng_hif_chnl *chnl, u32 *len, bool *lifm);
+#endif /* PFENG_CFG_XSK_SUPPORT */
 int pfeng_hif_chnl_txconf_put_map_frag(struct pfeng_hif_chnl *chnl, void *va_addr, addr_t pa_addr, u32 size, struct sk_buff *skb, u8 flags);
+void *pfeng_hif_chnl_txconf_copybreak_buf(struct pfeng_hif_chnl *chnl, dma_addr_t *des);
+int pfeng_hif_chnl_txconf_put_map_copy(struct pfeng_hif_chnl *chnl, void *va_addr, addr_t pa_addr, u32 size, struct net_device *netdev);
+void pfeng_hif_chnl_txconf_unroll_map_copy(struct pfeng_hif_chnl *chnl);
+int pfeng_hif_chnl_txconf_put_map_xdp(struct pfeng_hif_chnl *chnl, void *va_addr, addr_t pa_addr, u32 size, struct xdp_frame *xdpf, u8 flags);
+void pfeng_hif_chnl_txconf_unroll_map_xdp(struct pfeng_hif_chnl *chnl);
 u8 pfeng_hif_chnl_txconf_get_flag(struct pfeng_hif_chnl *chnl);
 struct sk_buff *pfeng_hif_chnl_txconf_get_skbuf(struct pfeng_hif_chnl *chnl);
+struct net_device *pfeng_hif_chnl_txconf_get_netdev(struct pfeng_hif_chnl *chnl, u32 *len);
 int pfeng_hif_chnl_txconf_unroll_map_full(struct pfeng_hif_chnl *chnl, u32 idx, u32 nfrags);
 int pfeng_hif_chnl_txconf_free_map_full(struct pfeng_hif_chnl *chnl);
 bool pfeng_hif_chnl_txconf_check(struct pfeng_hif_chnl *chnl, u32 elems);
+void pfeng_bman_get_stats(struct pfeng_hif_chnl *chnl, struct pfeng_bman_stats *stats);
+void pfeng_bman_rx_pool_show(struct seq_file *seq, struct pfeng_hif_chnl *chnl);
 
 /* netif */
 int pfeng_netif_create(struct pfeng_priv *priv);
 void pfeng_netif_remove(struct pfeng_priv *priv);
 int pfeng_netif_suspend(struct pfeng_priv *priv);
 int pfeng_netif_resume(struct pfeng_priv *priv);
+u32 pfeng_netif_get_max_hifs(struct pfeng_netif *netif);
+int pfeng_netif_set_hifs(struct pfeng_netif *netif, u32 count);
 void pfeng_ethtool_init(struct net_device *netdev);
+void pfeng_ethtool_stats_start(struct pfeng_netif *netif);
+void pfeng_ethtool_stats_stop(struct pfeng_netif *netif);
+void pfeng_rss_init(struct pfeng_netif *netif);
+int pfeng_rss_start(struct pfeng_netif *netif);
+void pfeng_rss_stop(struct pfeng_netif *netif, bool release);
+u32 pfeng_rss_get_indir_size(struct pfeng_netif *netif);
+void pfeng_rss_get_indir(struct pfeng_netif *netif, u32 *indir);
+int pfeng_rss_set_indir(struct pfeng_netif *netif, const u32 *indir);
+int pfeng_rss_set_queues(struct pfeng_netif *netif, u32 queues);
+int pfeng_rss_set_mac(struct pfeng_netif *netif);
+void pfeng_ntuple_init(struct pfeng_netif *netif);
+int pfeng_ntuple_start(struct pfeng_netif *netif);
+void pfeng_ntuple_stop(struct pfeng_netif *netif, bool release);
+int pfeng_ntuple_set_mac(struct pfeng_netif *netif);
+u32 pfeng_ntuple_get_count(struct pfeng_netif *netif);
+u32 pfeng_ntuple_get_rings(struct pfeng_netif *netif);
+int pfeng_ntuple_get_rule(struct pfeng_netif *netif, struct ethtool_rx_flow_spec *fs);
+int pfeng_ntuple_get_all(struct pfeng_netif *netif, u32 *rule_locs, u32 *cnt);
+int pfeng_ntuple_add(struct pfeng_netif *netif, struct ethtool_rx_flow_spec *fs);
+int pfeng_ntuple_del(struct pfeng_netif *netif, u32 location);
+void pfeng_netif_tx_hdr_init(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, pfe_ct_hif_tx_hdr_t *tx_hdr);
 int pfeng_phylink_create(struct pfeng_netif *netif);
 int pfeng_phylink_connect_phy(struct pfeng_netif *netif);
 int pfeng_phylink_start(struct pfeng_netif *netif);
@@ -315,6 +603,22 @@ void pfeng_phylink_disconnect_phy(struct pfeng_netif *netif);
 void pfeng_phylink_destroy(struct pfeng_netif *netif);
 void pfeng_phylink_mac_change(struct pfeng_netif *netif, bool up);
 
+/* xdp */
+int pfeng_xdp_bpf(struct net_device *netdev, struct netdev_bpf *bpf);
+int pfeng_xdp_xmit(struct net_device *netdev, int n, struct xdp_frame **frames, u32 flags);
+int pfeng_xdp_tx_frame(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, struct xdp_frame *xdpf, bool dma_map);
+u32 pfeng_xdp_run(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl, struct bpf_prog *prog, struct xdp_buff *xdp);
+void pfeng_xdp_finalize(struct pfeng_hif_chnl *chnl, u32 xdp_status);
+int pfeng_xdp_rxq_reg(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl);
+void pfeng_xdp_rxq_unreg(struct pfeng_netif *netif, struct pfeng_hif_chnl *chnl);
+#ifdef PFENG_CFG_XSK_SUPPORT
+int pfeng_xsk_pool_setup(struct pfeng_netif *netif, struct xsk_buff_pool *xsk_pool, u16 queue);
+int pfeng_xsk_check_mtu(struct pfeng_netif *netif, int mtu);
+int pfeng_xsk_wakeup(struct net_device *netdev, u32 queue, u32 flags);
+int pfeng_xsk_chnl_rx(struct pfeng_hif_chnl *chnl, int limit);
+bool pfeng_xsk_chnl_xmit(struct pfeng_hif_chnl *chnl, int budget);
+#endif /* PFENG_CFG_XSK_SUPPORT */
+
 /* ptp */
 void pfeng_ptp_register(struct pfeng_netif *netif);
 void pfeng_ptp_unregister(struct pfeng_netif *netif);
@@ -325,8 +629,10 @@ void pfeng_hwts_release(struct pfeng_netif *netif);
 void pfeng_hwts_skb_set_rx_ts(struct pfeng_netif *netif, struct sk_buff *skb);
 void pfeng_hwts_get_tx_ts(struct pfeng_netif *netif, struct sk_buff *skb);
 int pfeng_hwts_store_tx_ref(struct pfeng_netif *netif, struct sk_buff *skb);
+void pfeng_hwts_release_tx_ref(struct pfeng_netif *netif, struct sk_buff *skb, u16 ref_num);
 int pfeng_hwts_ioctl_set(struct pfeng_netif *netif, struct ifreq *rq);
 int pfeng_hwts_ioctl_get(struct pfeng_netif *netif, struct ifreq *rq);
 int pfeng_hwts_ethtool(struct pfeng_netif *netif, struct ethtool_ts_info *info);
+void pfeng_hwts_get_stats(struct pfeng_netif *netif, u64 *data);
 
 #endif
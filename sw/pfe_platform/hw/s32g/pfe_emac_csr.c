@@ -711,21 +711,19 @@ errno_t pfe_emac_cfg_get_link_status(addr_t base_va, pfe_emac_link_speed_t *link
 
 /**
  * @brief		Set maximum frame length
+ * @details		With giant packet limit control enabled (default) the limit is
+ *				programmed into GPSL, never below the standard frame size. In
+ *				other MAC configurations the function just performs check whether
+ *				the requested length is supported.
  * @param[in]	base_va Base address of MAC register space (virtual)
  * @param[in]	len The new maximum frame length
  * @return		EOK if success, error code if invalid value is requested
  */
 errno_t pfe_emac_cfg_set_max_frame_length(addr_t base_va, uint32_t len)
 {
-	uint32_t reg, maxlen = 0U;
+	uint32_t reg, maxlen = 0U, tags;
 	bool_t je, s2kp, gpslce, edvlp;
 
-	/*
-		In this case the function just performs check whether the requested length
-		is supported by the current MAC configuration. When change is needed then
-		particular parameters (JE, S2KP, GPSLCE, DVLP, and GPSL must be changed).
-	*/
-
 	reg = hal_read32(base_va + MAC_CONFIGURATION);
 	je = !!(reg & JUMBO_PACKET_ENABLE(1U));
 	s2kp = !!(reg & SUPPORT_2K_PACKETS(1U));
@@ -734,6 +732,23 @@ errno_t pfe_emac_cfg_set_max_frame_length(addr_t base_va, uint32_t len)
 	reg = hal_read32(base_va + MAC_VLAN_TAG_CTRL);
 	edvlp = !!(reg & ENABLE_DOUBLE_VLAN(1U));
 
+	if (!je && !s2kp && gpslce)
+	{
+		/*	GPSL does not count the VLAN tag(s) */
+		tags = (TRUE == edvlp) ? 8U : 4U;
+		if ((len < tags) || ((len - tags) > GIANT_PACKET_SIZE_LIMIT((uint32_t)-1)))
+		{
+			return EINVAL;
+		}
+
+		reg = hal_read32(base_va + MAC_EXT_CONFIGURATION);
+		reg &= ~GIANT_PACKET_SIZE_LIMIT((uint32_t)-1);
+		reg |= GIANT_PACKET_SIZE_LIMIT(((len - tags) < 1518U) ? 1518U : (len - tags));
+		hal_write32(reg, base_va + MAC_EXT_CONFIGURATION);
+
+		return EOK;
+	}
+
 	if (je && edvlp)
 	{
 		maxlen = 9026U;
@@ -744,13 +759,6 @@ errno_t pfe_emac_cfg_set_max_frame_length(addr_t base_va, uint32_t len)
 		maxlen = 2000U;
 	}
 
-	if (!je && !s2kp && gpslce && edvlp)
-	{
-		reg = hal_read32(base_va + MAC_EXT_CONFIGURATION);
-		maxlen = reg & GIANT_PACKET_SIZE_LIMIT((uint32_t)-1);
-		maxlen += 8U;
-	}
-
 	if (!je && !s2kp && !gpslce && edvlp)
 	{
 		maxlen = 1526U;
@@ -761,13 +769,6 @@ errno_t pfe_emac_cfg_set_max_frame_length(addr_t base_va, uint32_t len)
 		maxlen = 9022U;
 	}
 
-	if (!je && !s2kp && gpslce && !edvlp)
-	{
-		reg = hal_read32(base_va + MAC_EXT_CONFIGURATION);
-		maxlen = reg & GIANT_PACKET_SIZE_LIMIT((uint32_t)-1);
-		maxlen += 4U;
-	}
-
 	if (!je && !s2kp && !gpslce && !edvlp)
 	{
 		maxlen = 1522U;
@@ -1189,6 +1190,67 @@ uint32_t pfe_emac_cfg_get_rx_cnt(addr_t base_va)
 	return hal_read32(base_va + RX_PACKETS_COUNT_GOOD_BAD);
 }
 
+/**
+ * @brief		Read all RMON counters
+ * @param[in]	base_va Base address of EMAC register space (virtual)
+ * @param[out]	stats Counters
+ */
+void pfe_emac_cfg_get_rmon_stats(addr_t base_va, pfe_emac_rmon_stats_t *stats)
+{
+	stats->tx_octet_count_good_bad = hal_read32(base_va + TX_OCTET_COUNT_GOOD_BAD);
+	stats->tx_packet_count_good_bad = hal_read32(base_va + TX_PACKET_COUNT_GOOD_BAD);
+	stats->tx_broadcast_packets_good = hal_read32(base_va + TX_BROADCAST_PACKETS_GOOD);
+	stats->tx_multicast_packets_good = hal_read32(base_va + TX_MULTICAST_PACKETS_GOOD);
+	stats->tx_64octets_packets_good_bad = hal_read32(base_va + TX_64OCTETS_PACKETS_GOOD_BAD);
+	stats->tx_65to127octets_packets_good_bad = hal_read32(base_va + TX_65TO127OCTETS_PACKETS_GOOD_BAD);
+	stats->tx_128to255octets_packets_good_bad = hal_read32(base_va + TX_128TO255OCTETS_PACKETS_GOOD_BAD);
+	stats->tx_256to511octets_packets_good_bad = hal_read32(base_va + TX_256TO511OCTETS_PACKETS_GOOD_BAD);
+	stats->tx_512to1023octets_packets_good_bad = hal_read32(base_va + TX_512TO1023OCTETS_PACKETS_GOOD_BAD);
+	stats->tx_1024tomaxoctets_packets_good_bad = hal_read32(base_va + TX_1024TOMAXOCTETS_PACKETS_GOOD_BAD);
+	stats->tx_unicast_packets_good_bad = hal_read32(base_va + TX_UNICAST_PACKETS_GOOD_BAD);
+	stats->tx_multicast_packets_good_bad = hal_read32(base_va + TX_MULTICAST_PACKETS_GOOD_BAD);
+	stats->tx_broadcast_packets_good_bad = hal_read32(base_va + TX_BROADCAST_PACKETS_GOOD_BAD);
+	stats->tx_underflow_error_packets = hal_read32(base_va + TX_UNDERFLOW_ERROR_PACKETS);
+	stats->tx_single_collision_good_packets = hal_read32(base_va + TX_SINGLE_COLLISION_GOOD_PACKETS);
+	stats->tx_multiple_collision_good_packets = hal_read32(base_va + TX_MULTIPLE_COLLISION_GOOD_PACKETS);
+	stats->tx_deferred_packets = hal_read32(base_va + TX_DEFERRED_PACKETS);
+	stats->tx_late_collision_packets = hal_read32(base_va + TX_LATE_COLLISION_PACKETS);
+	stats->tx_excessive_collision_packets = hal_read32(base_va + TX_EXCESSIVE_COLLISION_PACKETS);
+	stats->tx_carrier_error_packets = hal_read32(base_va + TX_CARRIER_ERROR_PACKETS);
+	stats->tx_octet_count_good = hal_read32(base_va + TX_OCTET_COUNT_GOOD);
+	stats->tx_packet_count_good = hal_read32(base_va + TX_PACKET_COUNT_GOOD);
+	stats->tx_excessive_deferral_error = hal_read32(base_va + TX_EXCESSIVE_DEFERRAL_ERROR);
+	stats->tx_pause_packets = hal_read32(base_va + TX_PAUSE_PACKETS);
+	stats->tx_vlan_packets_good = hal_read32(base_va + TX_VLAN_PACKETS_GOOD);
+	stats->tx_osize_packets_good = hal_read32(base_va + TX_OSIZE_PACKETS_GOOD);
+	stats->rx_packets_count_good_bad = hal_read32(base_va + RX_PACKETS_COUNT_GOOD_BAD);
+	stats->rx_octet_count_good_bad = hal_read32(base_va + RX_OCTET_COUNT_GOOD_BAD);
+	stats->rx_octet_count_good = hal_read32(base_va + RX_OCTET_COUNT_GOOD);
+	stats->rx_broadcast_packets_good = hal_read32(base_va + RX_BROADCAST_PACKETS_GOOD);
+	stats->rx_multicast_packets_good = hal_read32(base_va + RX_MULTICAST_PACKETS_GOOD);
+	stats->rx_crc_error_packets = hal_read32(base_va + RX_CRC_ERROR_PACKETS);
+	stats->rx_alignment_error_packets = hal_read32(base_va + RX_ALIGNMENT_ERROR_PACKETS);
+	stats->rx_runt_error_packets = hal_read32(base_va + RX_RUNT_ERROR_PACKETS);
+	stats->rx_jabber_error_packets = hal_read32(base_va + RX_JABBER_ERROR_PACKETS);
+	stats->rx_undersize_packets_good = hal_read32(base_va + RX_UNDERSIZE_PACKETS_GOOD);
+	stats->rx_oversize_packets_good = hal_read32(base_va + RX_OVERSIZE_PACKETS_GOOD);
+	stats->rx_64octets_packets_good_bad = hal_read32(base_va + RX_64OCTETS_PACKETS_GOOD_BAD);
+	stats->rx_65to127octets_packets_good_bad = hal_read32(base_va + RX_65TO127OCTETS_PACKETS_GOOD_BAD);
+	stats->rx_128to255octets_packets_good_bad = hal_read32(base_va + RX_128TO255OCTETS_PACKETS_GOOD_BAD);
+	stats->rx_256to511octets_packets_good_bad = hal_read32(base_va + RX_256TO511OCTETS_PACKETS_GOOD_BAD);
+	stats->rx_512to1023octets_packets_good_bad = hal_read32(base_va + RX_512TO1023OCTETS_PACKETS_GOOD_BAD);
+	stats->rx_1024tomaxoctets_packets_good_bad = hal_read32(base_va + RX_1024TOMAXOCTETS_PACKETS_GOOD_BAD);
+	stats->rx_unicast_packets_good = hal_read32(base_va + RX_UNICAST_PACKETS_GOOD);
+	stats->rx_length_error_packets = hal_read32(base_va + RX_LENGTH_ERROR_PACKETS);
+	stats->rx_out_of_range_type_packets = hal_read32(base_va + RX_OUT_OF_RANGE_TYPE_PACKETS);
+	stats->rx_pause_packets = hal_read32(base_va + RX_PAUSE_PACKETS);
+	stats->rx_fifo_overflow_packets = hal_read32(base_va + RX_FIFO_OVERFLOW_PACKETS);
+	stats->rx_vlan_packets_good_bad = hal_read32(base_va + RX_VLAN_PACKETS_GOOD_BAD);
+	stats->rx_watchdog_error_packets = hal_read32(base_va + RX_WATCHDOG_ERROR_PACKETS);
+	stats->rx_receive_error_packets = hal_read32(base_va + RX_RECEIVE_ERROR_PACKETS);
+	stats->rx_control_packets_good = hal_read32(base_va + RX_CONTROL_PACKETS_GOOD);
+}
+
 /**
  * @brief		Get EMAC statistics in text form
  * @details		This is a HW-specific function providing detailed text statistics
@@ -315,5 +315,6 @@ errno_t pfe_emac_cfg_mdio_write45(addr_t base_va, uint8_t pa, uint8_t dev, uint1
 uint32_t pfe_emac_cfg_get_text_stat(addr_t base_va, char_t *buf, uint32_t size, uint8_t verb_level);
 uint32_t pfe_emac_cfg_get_tx_cnt(addr_t base_va);
 uint32_t pfe_emac_cfg_get_rx_cnt(addr_t base_va);
+void pfe_emac_cfg_get_rmon_stats(addr_t base_va, pfe_emac_rmon_stats_t *stats);
 
 #endif /* SRC_PFE_EMAC_CSR_H_ */
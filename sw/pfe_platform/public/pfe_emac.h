@@ -54,6 +54,66 @@ typedef enum
 
 typedef struct pfe_emac_tag pfe_emac_t;
 
+/**
+ * @brief	EMAC RMON (MMC) counters
+ * @details	Free running 32-bit HW counters, members follow the register order
+ */
+typedef struct
+{
+	uint32_t tx_octet_count_good_bad;
+	uint32_t tx_packet_count_good_bad;
+	uint32_t tx_broadcast_packets_good;
+	uint32_t tx_multicast_packets_good;
+	uint32_t tx_64octets_packets_good_bad;
+	uint32_t tx_65to127octets_packets_good_bad;
+	uint32_t tx_128to255octets_packets_good_bad;
+	uint32_t tx_256to511octets_packets_good_bad;
+	uint32_t tx_512to1023octets_packets_good_bad;
+	uint32_t tx_1024tomaxoctets_packets_good_bad;
+	uint32_t tx_unicast_packets_good_bad;
+	uint32_t tx_multicast_packets_good_bad;
+	uint32_t tx_broadcast_packets_good_bad;
+	uint32_t tx_underflow_error_packets;
+	uint32_t tx_single_collision_good_packets;
+	uint32_t tx_multiple_collision_good_packets;
+	uint32_t tx_deferred_packets;
+	uint32_t tx_late_collision_packets;
+	uint32_t tx_excessive_collision_packets;
+	uint32_t tx_carrier_error_packets;
+	uint32_t tx_octet_count_good;
+	uint32_t tx_packet_count_good;
+	uint32_t tx_excessive_deferral_error;
+	uint32_t tx_pause_packets;
+	uint32_t tx_vlan_packets_good;
+	uint32_t tx_osize_packets_good;
+	uint32_t rx_packets_count_good_bad;
+	uint32_t rx_octet_count_good_bad;
+	uint32_t rx_octet_count_good;
+	uint32_t rx_broadcast_packets_good;
+	uint32_t rx_multicast_packets_good;
+	uint32_t rx_crc_error_packets;
+	uint32_t rx_alignment_error_packets;
+	uint32_t rx_runt_error_packets;
+	uint32_t rx_jabber_error_packets;
+	uint32_t rx_undersize_packets_good;
+	uint32_t rx_oversize_packets_good;
+	uint32_t rx_64octets_packets_good_bad;
+	uint32_t rx_65to127octets_packets_good_bad;
+	uint32_t rx_128to255octets_packets_good_bad;
+	uint32_t rx_256to511octets_packets_good_bad;
+	uint32_t rx_512to1023octets_packets_good_bad;
+	uint32_t rx_1024tomaxoctets_packets_good_bad;
+	uint32_t rx_unicast_packets_good;
+	uint32_t rx_length_error_packets;
+	uint32_t rx_out_of_range_type_packets;
+	uint32_t rx_pause_packets;
+	uint32_t rx_fifo_overflow_packets;
+	uint32_t rx_vlan_packets_good_bad;
+	uint32_t rx_watchdog_error_packets;
+	uint32_t rx_receive_error_packets;
+	uint32_t rx_control_packets_good;
+} pfe_emac_rmon_stats_t;
+
 /**
  * @brief	The MAC address type
  * @details	Bytes are represented as:
@@ -192,6 +252,7 @@ void pfe_emac_destroy(pfe_emac_t *emac);
 uint32_t pfe_emac_get_text_statistics(const pfe_emac_t *emac, char_t *buf, uint32_t buf_len, uint8_t verb_level);
 uint32_t pfe_emac_get_rx_cnt(const pfe_emac_t *emac);
 uint32_t pfe_emac_get_tx_cnt(const pfe_emac_t *emac);
+errno_t pfe_emac_get_rmon_stats(const pfe_emac_t *emac, pfe_emac_rmon_stats_t *stats);
 
 
 #endif /* PUBLIC_PFE_EMAC_H_ */
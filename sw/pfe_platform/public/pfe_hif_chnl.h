@@ -66,6 +66,13 @@
  * 					}
  * 				@endcode
  *
+ * 				@note With PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER the RX ring is not protected
+ * 					  at all. Dequeue (pfe_hif_chnl_rx(), pfe_hif_chnl_rx_burst(),
+ * 					  pfe_hif_chnl_rx_va()) and refill (pfe_hif_chnl_supply_rx_buf(),
+ * 					  pfe_hif_chnl_supply_rx_bufs(), pfe_hif_chnl_release_buf()) of a channel
+ * 					  must then be serialized by the caller, e.g. by running them from a single
+ * 					  poll context only.
+ *
  * 				TX traffic management
  * 				---------------------
  * 				A packet can be committed for transmission using the pfe_hif_chnl_tx() call. Since
@@ -160,6 +167,20 @@
 #else
 #define PFE_HIF_CHNL_CFG_RX_OOB_EVENT_ENABLED	FALSE
 #endif
+
+/**
+ * @brief	RX single consumer
+ * @details	When TRUE then the caller guarantees the RX ring of a channel is dequeued
+ * 			and refilled from single context at a time (the NAPI poll on Linux) so the
+ * 			RX path runs without locks. FALSE keeps the RX resources protected by the
+ * 			channel RX lock. The pfeng driver built with PFE_CFG_DEBUG warns when the
+ * 			ring is accessed outside of the channel RX NAPI.
+ */
+#if !defined(PFE_CFG_TARGET_OS_LINUX)
+#define PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER		FALSE
+#else
+#define PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER		TRUE
+#endif
 #include "pfe_bmu.h"
 
 /**
@@ -184,26 +205,31 @@ typedef void (* pfe_hif_chnl_cbk_t)(void *arg);
 /*	RX */
 errno_t pfe_hif_chnl_rx_enable(pfe_hif_chnl_t *chnl) __attribute__((cold));
 void pfe_hif_chnl_rx_disable(pfe_hif_chnl_t *chnl) __attribute__((cold));
+errno_t pfe_hif_chnl_rx_drain(pfe_hif_chnl_t *chnl) __attribute__((cold));
 errno_t pfe_hif_chnl_rx(pfe_hif_chnl_t *chnl, void **buf_pa, uint32_t *len, bool_t *lifm) __attribute__((hot));
+uint32_t pfe_hif_chnl_rx_burst(pfe_hif_chnl_t *chnl, pfe_hif_ring_buf_t *bufs, uint32_t count) __attribute__((hot));
 errno_t pfe_hif_chnl_rx_va(const pfe_hif_chnl_t *chnl, void **buf_va, uint32_t *len, bool_t *lifm, void **meta) __attribute__((hot));
 uint32_t pfe_hif_chnl_get_meta_size(const pfe_hif_chnl_t *chnl) __attribute__((cold));
 errno_t pfe_hif_chnl_release_buf(pfe_hif_chnl_t *chnl, void *buf_va) __attribute__((hot));
 void pfe_hif_chnl_rx_dma_start(const pfe_hif_chnl_t *chnl) __attribute__((hot));
-bool_t pfe_hif_chnl_can_accept_rx_buf(const pfe_hif_chnl_t *chnl) __attribute__((pure, hot));
+bool_t pfe_hif_chnl_can_accept_rx_buf(const pfe_hif_chnl_t *chnl) __attribute__((hot));
 errno_t pfe_hif_chnl_supply_rx_buf(const pfe_hif_chnl_t *chnl, const void *buf_pa, uint32_t size) __attribute__((hot));
+uint32_t pfe_hif_chnl_supply_rx_bufs(const pfe_hif_chnl_t *chnl, const void *const *buf_pa, uint32_t size, uint32_t count) __attribute__((hot));
 uint32_t pfe_hif_chnl_get_rx_fifo_depth(const pfe_hif_chnl_t *chnl) __attribute__((pure, cold));
 
 /*	TX */
 errno_t pfe_hif_chnl_tx_enable(pfe_hif_chnl_t *chnl) __attribute__((cold));
 void pfe_hif_chnl_tx_disable(pfe_hif_chnl_t *chnl) __attribute__((cold));
 errno_t pfe_hif_chnl_tx(const pfe_hif_chnl_t *chnl, const void *buf_pa, const void *buf_va, uint32_t len, bool_t lifm) __attribute__((hot));
+errno_t pfe_hif_chnl_tx_enqueue(const pfe_hif_chnl_t *chnl, const void *buf_pa, const void *buf_va, uint32_t len, bool_t lifm) __attribute__((hot));
+errno_t pfe_hif_chnl_tx_burst(const pfe_hif_chnl_t *chnl, const pfe_hif_ring_buf_t *bufs, uint32_t count) __attribute__((hot));
 void pfe_hif_chnl_tx_dma_start(const pfe_hif_chnl_t *chnl) __attribute__((hot));
-bool_t pfe_hif_chnl_can_accept_tx_num(const pfe_hif_chnl_t *chnl, uint16_t num) __attribute__((pure, hot));
+bool_t pfe_hif_chnl_can_accept_tx_num(const pfe_hif_chnl_t *chnl, uint16_t num) __attribute__((hot));
 #ifdef PFE_CFG_HIF_TX_FIFO_FIX
 bool_t pfe_hif_chnl_can_accept_tx_data(pfe_hif_chnl_t *chnl, uint32_t num) __attribute__((hot));
 #endif /* PFE_CFG_HIF_TX_FIFO_FIX */
 bool_t pfe_hif_chnl_tx_fifo_empty(const pfe_hif_chnl_t *chnl) __attribute__((pure, hot));
-bool_t pfe_hif_chnl_has_tx_conf(const pfe_hif_chnl_t *chnl) __attribute__((pure, hot));
+bool_t pfe_hif_chnl_has_tx_conf(const pfe_hif_chnl_t *chnl) __attribute__((hot));
 errno_t pfe_hif_chnl_get_tx_conf(const pfe_hif_chnl_t *chnl) __attribute__((hot));
 uint32_t pfe_hif_chnl_get_tx_fifo_depth(const pfe_hif_chnl_t *chnl) __attribute__((pure, cold));
 
@@ -211,6 +237,7 @@ uint32_t pfe_hif_chnl_get_tx_fifo_depth(const pfe_hif_chnl_t *chnl) __attribute_
 pfe_hif_chnl_t *pfe_hif_chnl_create(addr_t cbus_base_va, uint32_t id, const pfe_bmu_t *bmu) __attribute__((cold));
 errno_t pfe_hif_chnl_isr(pfe_hif_chnl_t *chnl) __attribute__((hot));
 void pfe_hif_chnl_destroy(pfe_hif_chnl_t *chnl) __attribute__((cold));
+errno_t pfe_hif_chnl_set_ring_len(pfe_hif_chnl_t *chnl, uint32_t rx_len, uint32_t tx_len) __attribute__((cold));
 errno_t pfe_hif_chnl_set_event_cbk(pfe_hif_chnl_t *chnl, pfe_hif_chnl_event_t event, pfe_hif_chnl_cbk_t cbk, void *arg);
 void pfe_hif_chnl_irq_mask(pfe_hif_chnl_t *chnl);
 void pfe_hif_chnl_irq_unmask(pfe_hif_chnl_t *chnl);
@@ -16,14 +16,27 @@
 
 typedef struct pfe_hif_ring_tag pfe_hif_ring_t;
 
-pfe_hif_ring_t *pfe_hif_ring_create(bool_t rx, uint16_t seqnum, bool_t nocpy) __attribute__((cold));
+/**
+ * @brief	Buffer of a burst enqueue or dequeue request
+ */
+typedef struct
+{
+	void *buf_pa;	/*	Physical address of the buffer */
+	uint32_t len;	/*	Length of the buffer */
+	bool_t lifm;	/*	Last buffer of a frame */
+} pfe_hif_ring_buf_t;
+
+pfe_hif_ring_t *pfe_hif_ring_create(bool_t rx, uint16_t seqnum, bool_t nocpy, uint32_t len) __attribute__((cold));
 uint32_t pfe_hif_ring_get_len(const pfe_hif_ring_t *ring) __attribute__((pure, hot));
 errno_t pfe_hif_ring_destroy(pfe_hif_ring_t *ring) __attribute__((cold));
 void *pfe_hif_ring_get_base_pa(const pfe_hif_ring_t *ring) __attribute__((pure, cold));
 void *pfe_hif_ring_get_wb_tbl_pa(const pfe_hif_ring_t *ring) __attribute__((pure, cold));
 uint32_t pfe_hif_ring_get_wb_tbl_len(const pfe_hif_ring_t *ring) __attribute__((pure, cold));
 errno_t pfe_hif_ring_enqueue_buf(pfe_hif_ring_t *ring, const void *buf_pa, uint32_t length, bool_t lifm) __attribute__((hot));
+uint32_t pfe_hif_ring_enqueue_rx_bufs(pfe_hif_ring_t *ring, const void *const *buf_pa, uint32_t length, uint32_t count) __attribute__((hot));
+errno_t pfe_hif_ring_enqueue_bufs(pfe_hif_ring_t *ring, const pfe_hif_ring_buf_t *bufs, uint32_t count) __attribute__((hot));
 errno_t pfe_hif_ring_dequeue_buf(pfe_hif_ring_t *ring, void **buf_pa, uint32_t *length, bool_t *lifm) __attribute__((hot));
+uint32_t pfe_hif_ring_dequeue_bufs(pfe_hif_ring_t *ring, pfe_hif_ring_buf_t *bufs, uint32_t count) __attribute__((hot));
 #ifdef PFE_CFG_HIF_TX_FIFO_FIX
 errno_t pfe_hif_ring_dequeue_plain(pfe_hif_ring_t *ring, bool_t *lifm, uint32_t *len) __attribute__((hot));
 #else
@@ -33,6 +46,8 @@ errno_t pfe_hif_ring_drain_buf(pfe_hif_ring_t *ring, void **buf_pa) __attribute_
 bool_t spfe_hif_ring_is_below_wm(const pfe_hif_ring_t *ring) __attribute__((pure, hot));
 void pfe_hif_ring_invalidate(const pfe_hif_ring_t *ring) __attribute__((cold));
 uint32_t pfe_hif_ring_get_fill_level(const pfe_hif_ring_t *ring) __attribute__((pure, hot));
+bool_t pfe_hif_ring_can_enqueue(pfe_hif_ring_t *ring, uint32_t num) __attribute__((hot));
+bool_t pfe_hif_ring_is_empty(pfe_hif_ring_t *ring) __attribute__((hot));
 uint32_t pfe_hif_ring_dump(pfe_hif_ring_t *ring, char_t *name, char_t *buf, uint32_t size, uint8_t verb_level);
 #if defined(PFE_CFG_HIF_NOCPY_DIRECT)
 void pfe_hif_ring_set_egress_if(pfe_hif_ring_t *ring, pfe_ct_phy_if_id_t id) __attribute__((hot));
@@ -14,11 +14,18 @@
 #define TMU_TYPE_TMU_LITE	2U
 
 /**
- * @brief	Number of entries of a HIF ring
+ * @brief	Default number of entries of a HIF ring
  * @note	Must be power of 2
  */
 #define PFE_HIF_RING_CFG_LENGTH				256U
 
+/**
+ * @brief	Limits of the HIF ring length configurable in runtime
+ * @note	Must be power of 2
+ */
+#define PFE_HIF_RING_CFG_LENGTH_MIN			64U
+#define PFE_HIF_RING_CFG_LENGTH_MAX			4096U
+
 /*
  * @brief TMU variant
  */
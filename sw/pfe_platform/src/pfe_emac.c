@@ -1811,6 +1811,28 @@ uint32_t pfe_emac_get_tx_cnt(const pfe_emac_t *emac)
 	return pfe_emac_cfg_get_tx_cnt(emac->emac_base_va);
 }
 
+/**
+ * @brief		Get EMAC RMON counters
+ * @param[in]	emac The EMAC instance
+ * @param[out]	stats Current values of the counters
+ * @retval		EOK Success
+ * @retval		EINVAL Invalid or missing argument
+ */
+errno_t pfe_emac_get_rmon_stats(const pfe_emac_t *emac, pfe_emac_rmon_stats_t *stats)
+{
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely((NULL == emac) || (NULL == stats)))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return EINVAL;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+	pfe_emac_cfg_get_rmon_stats(emac->emac_base_va, stats);
+
+	return EOK;
+}
+
 /**
  * @brief		Return EMAC runtime statistics in text form
  * @details		Function writes formatted text into given buffer.
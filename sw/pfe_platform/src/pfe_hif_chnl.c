@@ -128,7 +128,9 @@ struct __attribute__((aligned(HAL_CACHE_LINE_SIZE))) __pfe_hif_chnl_tag
 #endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
 #endif /* PFE_HIF_CHNL_CFG_RX_BUFFERS_ENABLED */
 	oal_spinlock_t lock __attribute__((aligned(HAL_CACHE_LINE_SIZE)));				/*	Channel HW resources protection */
+#if (FALSE == PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER)
 	oal_spinlock_t rx_lock __attribute__((aligned(HAL_CACHE_LINE_SIZE)));			/*	RX resource protection */
+#endif /* PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER */
 	pfe_hif_chnl_cbk_storage_t rx_cbk;		/*	RX callback */
 	pfe_hif_chnl_cbk_storage_t tx_cbk;		/*	TX callback */
 #if (TRUE == PFE_HIF_CHNL_CFG_RX_OOB_EVENT_ENABLED)
@@ -404,6 +406,7 @@ __attribute__((cold)) pfe_hif_chnl_t *pfe_hif_chnl_create(addr_t cbus_base_va, u
 			return NULL;
 		}
 
+#if (FALSE == PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER)
 		if (EOK != oal_spinlock_init(&chnl->rx_lock))
 		{
 			NXP_LOG_ERROR("Channel RX mutex initialization failed\n");
@@ -414,6 +417,7 @@ __attribute__((cold)) pfe_hif_chnl_t *pfe_hif_chnl_create(addr_t cbus_base_va, u
 			oal_mm_free_contig(chnl);
 			return NULL;
 		}
+#endif /* PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER */
 
 #if defined(PFE_CFG_HIF_TX_FIFO_FIX)
 		if (0U == cbc_lock_initialized)
@@ -422,7 +426,9 @@ __attribute__((cold)) pfe_hif_chnl_t *pfe_hif_chnl_create(addr_t cbus_base_va, u
 			{
 				NXP_LOG_ERROR("CBC lock initialization failed\n");
 				(void)oal_spinlock_destroy(&chnl->lock);
+#if (FALSE == PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER)
 				(void)oal_spinlock_destroy(&chnl->rx_lock);
+#endif /* PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER */
 				oal_mm_free_contig(chnl);
 				return NULL;
 			}
@@ -481,7 +487,9 @@ __attribute__((cold)) pfe_hif_chnl_t *pfe_hif_chnl_create(addr_t cbus_base_va, u
 
 free_and_fail:
 	(void)oal_spinlock_destroy(&chnl->lock);
+#if (FALSE == PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER)
 	(void)oal_spinlock_destroy(&chnl->rx_lock);
+#endif /* PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER */
 #if defined(PFE_CFG_HIF_TX_FIFO_FIX)
 	cbc_lock_initialized--;
 	if (0U == cbc_lock_initialized)
@@ -700,6 +708,58 @@ __attribute__((cold)) void pfe_hif_chnl_rx_disable(pfe_hif_chnl_t *chnl)
 	}
 }
 
+/**
+ * @brief		Release all buffers enqueued in the RX ring
+ * @details		Stops the RX, takes all buffers out of the RX ring and flushes
+ * 				internal BD FIFO so the channel does not refer to any of them.
+ * 				Ring can be populated again by pfe_hif_chnl_supply_rx_buf()
+ * 				afterwards. Intended to replace the RX buffers source of the
+ * 				running channel.
+ * @param[in]	chnl The channel instance
+ * @return		EOK if success, error code otherwise
+ * @note		Released buffers must stay valid until the function returns.
+ * @note		The BD FIFO flush transmits dummy frames so caller shall ensure that
+ * 				the TX ring is empty and all TX confirmations have been processed.
+ * 				Both RX and TX are enabled on return.
+ */
+__attribute__((cold)) errno_t pfe_hif_chnl_rx_drain(pfe_hif_chnl_t *chnl)
+{
+	void *buf_pa;
+
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely(NULL == chnl))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return EINVAL;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	if (chnl->id >= PFE_HIF_CHNL_NOCPY_ID)
+	{
+		/*	HIF NOCPY RX buffers are owned by BMU */
+		return EPERM;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+	if (NULL == chnl->rx_ring)
+	{
+		return EFAULT;
+	}
+
+	/*	Stop data reception */
+	pfe_hif_chnl_rx_disable(chnl);
+
+	/*	Take all enqueued buffers */
+	while (EOK == pfe_hif_ring_drain_buf(chnl->rx_ring, &buf_pa))
+	{
+		;
+	}
+
+	/*	BDs may still be prefetched by HW. Flush them with dummy frames. */
+	return pfe_hif_chnl_flush_rx_bd_fifo(chnl);
+}
+
 /**
  * @brief		Trigger RX DMA
  * @details		One can trigger the HW to start processing of the RX ring.
@@ -1029,7 +1089,7 @@ errno_t pfe_hif_chnl_set_rx_irq_coalesce(pfe_hif_chnl_t *chnl, uint32_t frames,
  * @param[in]	chnl The channel instance
  * @return		TRUE if channel got new TX confirmation, FALSE otherwise
  */
-__attribute__((pure, hot)) bool_t pfe_hif_chnl_has_tx_conf(const pfe_hif_chnl_t *chnl)
+__attribute__((hot)) bool_t pfe_hif_chnl_has_tx_conf(const pfe_hif_chnl_t *chnl)
 {
 #if defined(PFE_CFG_NULL_ARG_CHECK)
 	if (unlikely(NULL == chnl))
@@ -1039,7 +1099,7 @@ __attribute__((pure, hot)) bool_t pfe_hif_chnl_has_tx_conf(const pfe_hif_chnl_t
 	}
 #endif /* PFE_CFG_NULL_ARG_CHECK */
 
-	return 0 != pfe_hif_ring_get_fill_level(chnl->tx_ring);
+	return FALSE == pfe_hif_ring_is_empty(chnl->tx_ring);
 }
 
 /**
@@ -1047,7 +1107,7 @@ __attribute__((pure, hot)) bool_t pfe_hif_chnl_has_tx_conf(const pfe_hif_chnl_t
  * @param		chnl The channel instance
  * @return		TRUE if RX resource can accept new buffer
  */
-__attribute__((pure, hot)) bool_t pfe_hif_chnl_can_accept_rx_buf(const pfe_hif_chnl_t *chnl)
+__attribute__((hot)) bool_t pfe_hif_chnl_can_accept_rx_buf(const pfe_hif_chnl_t *chnl)
 {
 #if defined(PFE_CFG_NULL_ARG_CHECK)
 	if (unlikely(NULL == chnl))
@@ -1057,9 +1117,7 @@ __attribute__((pure, hot)) bool_t pfe_hif_chnl_can_accept_rx_buf(const pfe_hif_c
 	}
 #endif /* PFE_CFG_NULL_ARG_CHECK */
 
-	/*	A single entry must remain unused within the ring
-	 	because HIF expects that. */
-	return (pfe_hif_ring_get_fill_level(chnl->rx_ring) < (pfe_hif_ring_get_len(chnl->rx_ring) - 1U));
+	return pfe_hif_ring_can_enqueue(chnl->rx_ring, 1U);
 }
 
 /**
@@ -1069,7 +1127,7 @@ __attribute__((pure, hot)) bool_t pfe_hif_chnl_can_accept_rx_buf(const pfe_hif_c
  * @retval		TRUE Channel can accept 'num' TX requests (buffers)
  * @retval		FALSE Not enough space in TX FIFO
  */
-__attribute__((pure, hot)) bool_t pfe_hif_chnl_can_accept_tx_num(const pfe_hif_chnl_t *chnl, uint16_t num)
+__attribute__((hot)) bool_t pfe_hif_chnl_can_accept_tx_num(const pfe_hif_chnl_t *chnl, uint16_t num)
 {
 #if defined(PFE_CFG_NULL_ARG_CHECK)
 	if (unlikely(NULL == chnl))
@@ -1079,8 +1137,7 @@ __attribute__((pure, hot)) bool_t pfe_hif_chnl_can_accept_tx_num(const pfe_hif_c
 	}
 #endif /* PFE_CFG_NULL_ARG_CHECK */
 
-	/*	A single entry must remain unused within the ring because HIF expects that. */
-	return ((pfe_hif_ring_get_len(chnl->tx_ring) - 1U - pfe_hif_ring_get_fill_level(chnl->tx_ring)) >= num);
+	return pfe_hif_ring_can_enqueue(chnl->tx_ring, num);
 }
 
 #ifdef PFE_CFG_HIF_TX_FIFO_FIX
@@ -1192,7 +1249,10 @@ __attribute__((pure, cold)) uint32_t pfe_hif_chnl_get_tx_fifo_depth(const pfe_hi
 }
 
 /**
- * @brief		Request transmission of a buffer
+ * @brief		Enqueue a buffer for transmission without triggering the DMA
+ * @details		Same as pfe_hif_chnl_tx() but the TX DMA is not triggered. Caller
+ * 				can enqueue several frames and trigger the transmission once
+ * 				via pfe_hif_chnl_tx_dma_start().
  * @note		The TX resource availability shall be checked before this function
  * 				is called using the pfe_hif_chnl_can_accept_tx_buf() call.
  * @note		Function is __NOT__ reentrant
@@ -1207,7 +1267,7 @@ __attribute__((pure, cold)) uint32_t pfe_hif_chnl_get_tx_fifo_depth(const pfe_hi
  * @retval		ENOSPC TX queue is full
  * @retval		EIO Internal error
  */
-__attribute__((hot)) errno_t pfe_hif_chnl_tx(const pfe_hif_chnl_t *chnl, const void *buf_pa, const void *buf_va, uint32_t len, bool_t lifm)
+__attribute__((hot)) errno_t pfe_hif_chnl_tx_enqueue(const pfe_hif_chnl_t *chnl, const void *buf_pa, const void *buf_va, uint32_t len, bool_t lifm)
 {
 	errno_t err = EOK;
 #if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
@@ -1352,6 +1412,33 @@ __attribute__((hot)) errno_t pfe_hif_chnl_tx(const pfe_hif_chnl_t *chnl, const v
 #endif /* PFE_CFG_HIF_TX_FIFO_FIX */
 	}
 
+	return err;
+}
+
+/**
+ * @brief		Request transmission of a buffer
+ * @details		The TX DMA is triggered when the last buffer of the frame is
+ * 				enqueued. See pfe_hif_chnl_tx_enqueue().
+ * @note		The TX resource availability shall be checked before this function
+ * 				is called using the pfe_hif_chnl_can_accept_tx_buf() call.
+ * @note		Function is __NOT__ reentrant
+ * @param[in]	chnl The channel instance
+ * @param[in]	buf_pa Physical address of the buffer to be transmitted
+ * @param[in]	buf_va Virtual address of the buffer to be transmitted
+ * @param[in]	len Length of the buffer in bytes
+ * @param[in]	lifm The last-in-frame indicator. Complete packet can consist
+ * 				     of multiple buffers. The last one shall be marked with
+ * 				     lifm=TRUE.
+ * @retval		EOK Success
+ * @retval		ENOSPC TX queue is full
+ * @retval		EIO Internal error
+ */
+__attribute__((hot)) errno_t pfe_hif_chnl_tx(const pfe_hif_chnl_t *chnl, const void *buf_pa, const void *buf_va, uint32_t len, bool_t lifm)
+{
+	errno_t err;
+
+	err = pfe_hif_chnl_tx_enqueue(chnl, buf_pa, buf_va, len, lifm);
+
 	if (TRUE == lifm)
 	{
 		/*	Trigger the DMA */
@@ -1361,6 +1448,74 @@ __attribute__((hot)) errno_t pfe_hif_chnl_tx(const pfe_hif_chnl_t *chnl, const v
 	return err;
 }
 
+/**
+ * @brief		Enqueue burst of buffers for transmission without triggering the DMA
+ * @details		Burst variant of pfe_hif_chnl_tx_enqueue(). The buffers can form one
+ * 				or more frames, the last buffer of each frame shall have lifm set.
+ * 				Either all buffers are enqueued or none. Transmission is triggered
+ * 				by pfe_hif_chnl_tx_dma_start().
+ * @note		Buffers must be already written back from CPU cache and the HIF
+ * 				NOCPY channel, which copies each buffer by CPU, is not supported.
+ * @note		Function is __NOT__ reentrant
+ * @param[in]	chnl The channel instance
+ * @param[in]	bufs Array of buffers to be transmitted
+ * @param[in]	count Number of buffers in the array
+ * @retval		EOK Success
+ * @retval		ENOSPC TX queue can't take the whole burst
+ * @retval		EPERM Not supported by the channel
+ */
+__attribute__((hot)) errno_t pfe_hif_chnl_tx_burst(const pfe_hif_chnl_t *chnl, const pfe_hif_ring_buf_t *bufs, uint32_t count)
+{
+	errno_t err;
+#ifdef PFE_CFG_HIF_TX_FIFO_FIX
+	uint32_t ii, len = 0U;
+#endif /* PFE_CFG_HIF_TX_FIFO_FIX */
+
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely((NULL == chnl) || (NULL == bufs)))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return EINVAL;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	if (unlikely(chnl->id >= PFE_HIF_CHNL_NOCPY_ID))
+	{
+		return EPERM;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+#ifdef PFE_CFG_HIF_TX_FIFO_FIX
+	for (ii = 0U; ii < count; ii++)
+	{
+		len += bufs[ii].len;
+	}
+
+	/*	Protect the CBC counter */
+	if (EOK != oal_spinlock_lock(&cbc_lock))
+	{
+		NXP_LOG_DEBUG("Spinlock lock failed\n");
+	}
+#endif /* PFE_CFG_HIF_TX_FIFO_FIX */
+
+	err = pfe_hif_ring_enqueue_bufs(chnl->tx_ring, bufs, count);
+
+#ifdef PFE_CFG_HIF_TX_FIFO_FIX
+	if (EOK == err)
+	{
+		pfe_hif_tx_cbc += len;
+	}
+
+	if (EOK != oal_spinlock_unlock(&cbc_lock))
+	{
+		NXP_LOG_DEBUG("Spinlock unlock failed\n");
+	}
+#endif /* PFE_CFG_HIF_TX_FIFO_FIX */
+
+	return err;
+}
+
 /**
  * @brief		Get TX confirmation
  * @details		Each frame transmitted via pfe_hif_chnl_tx() will produce exactly
@@ -1456,7 +1611,7 @@ __attribute__((hot)) errno_t pfe_hif_chnl_rx(pfe_hif_chnl_t *chnl, void **buf_pa
 
 #if (TRUE == PFE_HIF_CHNL_CFG_RX_OOB_EVENT_ENABLED)
 	/*	Check if ring has enough RX buffers */
-	if (unlikely(0U == pfe_hif_ring_get_fill_level(chnl->rx_ring)))
+	if (unlikely(pfe_hif_ring_is_empty(chnl->rx_ring)))
 	{
 		/*	Out of RX buffers */
 		if (likely(NULL != chnl->rx_oob_cbk.cbk))
@@ -1468,6 +1623,44 @@ __attribute__((hot)) errno_t pfe_hif_chnl_rx(pfe_hif_chnl_t *chnl, void **buf_pa
 
 	return err;
 }
+
+/**
+ * @brief		Receive burst of buffers
+ * @details		Burst variant of pfe_hif_chnl_rx(). Buffers are returned in the
+ * 				order they were received.
+ * @param[in]	chnl The channel instance
+ * @param[out]	bufs Array where the received buffers (physical addresses) shall be written
+ * @param[in]	count Size of the array
+ * @return		Number of received buffers, 0 if there is no more data right now
+ */
+__attribute__((hot)) uint32_t pfe_hif_chnl_rx_burst(pfe_hif_chnl_t *chnl, pfe_hif_ring_buf_t *bufs, uint32_t count)
+{
+	uint32_t num;
+
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely((NULL == chnl) || (NULL == bufs) || (NULL == chnl->rx_ring)))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return 0U;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+	num = pfe_hif_ring_dequeue_bufs(chnl->rx_ring, bufs, count);
+
+#if (TRUE == PFE_HIF_CHNL_CFG_RX_OOB_EVENT_ENABLED)
+	/*	Check if ring has enough RX buffers */
+	if (unlikely(pfe_hif_ring_is_empty(chnl->rx_ring)))
+	{
+		/*	Out of RX buffers */
+		if (likely(NULL != chnl->rx_oob_cbk.cbk))
+		{
+			chnl->rx_oob_cbk.cbk(chnl->rx_oob_cbk.arg);
+		}
+	}
+#endif
+
+	return num;
+}
 #endif /* PFE_HIF_CHNL_CFG_RX_BUFFERS_ENABLED */
 #if (TRUE == PFE_HIF_CHNL_CFG_RX_BUFFERS_ENABLED)
 
@@ -1668,18 +1861,22 @@ __attribute__((hot)) errno_t pfe_hif_chnl_release_buf(pfe_hif_chnl_t *chnl, void
 	#endif /* PFE_CFG_IP_VERSION */
 #endif /* HAL_HANDLE_CACHE */
 
+#if (FALSE == PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER)
 		if (unlikely(EOK != oal_spinlock_lock(&chnl->rx_lock)))
 		{
 			NXP_LOG_DEBUG("Mutex lock failed\n");
 		}
+#endif /* PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER */
 
 		/*	Release the buffer to ring */
 		ret = pfe_hif_ring_enqueue_buf(chnl->rx_ring, (void *)buf_pa, PFE_BUF_SIZE, TRUE);
 
+#if (FALSE == PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER)
 		if (unlikely(EOK != oal_spinlock_unlock(&chnl->rx_lock)))
 		{
 			NXP_LOG_DEBUG("Mutex unlock failed\n");
 		}
+#endif /* PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER */
 	}
 
 	return ret;
@@ -1726,6 +1923,40 @@ __attribute__((hot)) errno_t pfe_hif_chnl_supply_rx_buf(const pfe_hif_chnl_t *ch
 	return err;
 }
 
+/**
+ * @brief		Supply batch of RX buffers to be used for data reception
+ * @details		Cheaper than supplying the buffers one by one, the ring is
+ * 				updated at once. The HW has to be notified by a single
+ * 				pfe_hif_chnl_rx_dma_start() afterwards.
+ * @param[in]	chnl The channel instance
+ * @param[in]	buf_pa Array of RX buffers to be supplied (physical addresses, as
+ * 					   seen by host)
+ * @param[in]	size Size of each supplied buffer in bytes
+ * @param[in]	count Number of buffers in the array
+ * @return		Number of buffers supplied, less than count if the ring is full
+ * @note		Must not be preempted by pfe_hif_chnl_rx_disable()
+ */
+__attribute__((hot)) uint32_t pfe_hif_chnl_supply_rx_bufs(const pfe_hif_chnl_t *chnl, const void *const *buf_pa, uint32_t size, uint32_t count)
+{
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely((NULL == chnl) || (NULL == buf_pa)))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return 0U;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	if (chnl->id >= PFE_HIF_CHNL_NOCPY_ID)
+	{
+		/*	There is noting to supply to HIF NOCPY */
+		return 0U;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+	return pfe_hif_ring_enqueue_rx_bufs(chnl->rx_ring, buf_pa, size, count);
+}
+
 /**
  * @brief		Assign RX BD ring
  * @details		Configure RX buffer descriptor ring address of the channel.
@@ -1856,6 +2087,114 @@ __attribute__((cold)) static errno_t pfe_hif_chnl_set_tx_ring(pfe_hif_chnl_t *ch
 	return EOK;
 }
 
+/**
+ * @brief		Re-create RX and TX BD rings with new length
+ * @details		Replaces both rings of an initialized channel. Channel must be
+ * 				stopped: RX and TX disabled, RX ring drained by pfe_hif_chnl_rx_drain()
+ * 				and all TX confirmations processed. New rings are empty and the
+ * 				RX/TX stays disabled on return.
+ * @param[in]	chnl The channel instance
+ * @param[in]	rx_len New RX ring length, power of 2
+ * @param[in]	tx_len New TX ring length, power of 2
+ * @retval		EOK Success
+ * @retval		EINVAL Invalid argument
+ * @retval		EPERM Operation not supported by the channel
+ * @retval		EBUSY Channel is active or rings are not empty
+ * @retval		ENOMEM Rings can't be created, the current ones are kept
+ * @retval		EFAULT Rings can't be bound, the current ones are kept
+ */
+__attribute__((cold)) errno_t pfe_hif_chnl_set_ring_len(pfe_hif_chnl_t *chnl, uint32_t rx_len, uint32_t tx_len)
+{
+	pfe_hif_ring_t *rx_ring, *tx_ring, *old_rx_ring, *old_tx_ring;
+	uint16_t rx_seqnum, tx_seqnum;
+	errno_t ret;
+
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely(NULL == chnl))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return EINVAL;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	if (chnl->id >= PFE_HIF_CHNL_NOCPY_ID)
+	{
+		/*	HIF NOCPY RX buffers are owned by BMU */
+		return EPERM;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+#if (TRUE == PFE_HIF_CHNL_CFG_RX_BUFFERS_ENABLED)
+	/*	Internal RX buffer pool is sized according to the ring */
+	return EPERM;
+#else
+	if ((NULL == chnl->rx_ring) || (NULL == chnl->tx_ring))
+	{
+		return EINVAL;
+	}
+
+	if ((TRUE == pfe_hif_chnl_is_rx_dma_active(chnl)) || (TRUE == pfe_hif_chnl_is_tx_dma_active(chnl)))
+	{
+		NXP_LOG_ERROR("Channel %u is active\n", (uint_t)chnl->id);
+		return EBUSY;
+	}
+
+	if ((0U != pfe_hif_ring_get_fill_level(chnl->rx_ring)) || (0U != pfe_hif_ring_get_fill_level(chnl->tx_ring)))
+	{
+		NXP_LOG_ERROR("Channel %u rings are not empty\n", (uint_t)chnl->id);
+		return EBUSY;
+	}
+
+	/*	Continue with sequence numbers expected by HW */
+#ifdef PFE_CFG_HIF_SEQNUM_CHECK
+	rx_seqnum = pfe_hif_chnl_cfg_get_rx_seqnum(chnl->cbus_base_va, chnl->id);
+	tx_seqnum = pfe_hif_chnl_cfg_get_tx_seqnum(chnl->cbus_base_va, chnl->id);
+#else
+	rx_seqnum = 0U;
+	tx_seqnum = 0U;
+#endif /* PFE_CFG_HIF_SEQNUM_CHECK */
+
+	rx_ring = pfe_hif_ring_create(TRUE, rx_seqnum, FALSE, rx_len);
+	tx_ring = pfe_hif_ring_create(FALSE, tx_seqnum, FALSE, tx_len);
+	if ((NULL == rx_ring) || (NULL == tx_ring))
+	{
+		NXP_LOG_ERROR("Couldn't create BD rings (%u/%u)\n", (uint_t)rx_len, (uint_t)tx_len);
+		(void)pfe_hif_ring_destroy(rx_ring);
+		(void)pfe_hif_ring_destroy(tx_ring);
+		return ENOMEM;
+	}
+
+	old_rx_ring = chnl->rx_ring;
+	old_tx_ring = chnl->tx_ring;
+
+	/*	Bind both new rings or none of them. Failure means invalid ring and channel is left untouched. */
+	ret = pfe_hif_chnl_set_rx_ring(chnl, rx_ring);
+	if (EOK == ret)
+	{
+		ret = pfe_hif_chnl_set_tx_ring(chnl, tx_ring);
+		if (EOK != ret)
+		{
+			/*	Old RX ring has been bound before so it can't fail */
+			(void)pfe_hif_chnl_set_rx_ring(chnl, old_rx_ring);
+		}
+	}
+
+	if (EOK != ret)
+	{
+		NXP_LOG_ERROR("Couldn't bind BD rings: %d\n", ret);
+		(void)pfe_hif_ring_destroy(rx_ring);
+		(void)pfe_hif_ring_destroy(tx_ring);
+		return EFAULT;
+	}
+
+	(void)pfe_hif_ring_destroy(old_rx_ring);
+	(void)pfe_hif_ring_destroy(old_tx_ring);
+
+	return EOK;
+#endif /* PFE_HIF_CHNL_CFG_RX_BUFFERS_ENABLED */
+}
+
 /**
  * @brief		Initialize a channel
  * @details		Function prepares the HIF channel according to user-supplied parameters.
@@ -1889,7 +2228,7 @@ static __attribute__((cold)) errno_t pfe_hif_chnl_init(pfe_hif_chnl_t *chnl)
 
 	if (NULL != chnl->rx_ring)
 	{
-		/*	TODO: Re-initialize the RX ring with new size */
+		/*	Use pfe_hif_chnl_set_ring_len() to re-initialize the RX ring with new size */
 		NXP_LOG_ERROR("RX ring already initialized\n");
 		goto free_and_fail;
 	}
@@ -1901,7 +2240,7 @@ static __attribute__((cold)) errno_t pfe_hif_chnl_init(pfe_hif_chnl_t *chnl)
 #else
 	seqnum = 0U;
 #endif /* PFE_CFG_HIF_SEQNUM_CHECK */
-	rx_ring = pfe_hif_ring_create(TRUE, seqnum, (PFE_HIF_CHNL_NOCPY_ID == chnl->id));
+	rx_ring = pfe_hif_ring_create(TRUE, seqnum, (PFE_HIF_CHNL_NOCPY_ID == chnl->id), PFE_HIF_RING_CFG_LENGTH);
 	if (NULL == rx_ring)
 	{
 		NXP_LOG_ERROR("Couldn't create RX BD ring\n");
@@ -1918,7 +2257,7 @@ static __attribute__((cold)) errno_t pfe_hif_chnl_init(pfe_hif_chnl_t *chnl)
 
 	if (NULL != chnl->tx_ring)
 	{
-		/*	TODO: Re-initialize the TX ring with new size */
+		/*	Use pfe_hif_chnl_set_ring_len() to re-initialize the TX ring with new size */
 		NXP_LOG_WARNING("TX ring already initialized\n");
 		goto free_and_fail;
 	}
@@ -1930,7 +2269,7 @@ static __attribute__((cold)) errno_t pfe_hif_chnl_init(pfe_hif_chnl_t *chnl)
 #else
 	seqnum = 0U;
 #endif /* PFE_CFG_HIF_SEQNUM_CHECK */
-	tx_ring = pfe_hif_ring_create(FALSE, seqnum, (PFE_HIF_CHNL_NOCPY_ID == chnl->id));
+	tx_ring = pfe_hif_ring_create(FALSE, seqnum, (PFE_HIF_CHNL_NOCPY_ID == chnl->id), PFE_HIF_RING_CFG_LENGTH);
 	if (NULL == tx_ring)
 	{
 		NXP_LOG_ERROR("Couldn't create TX BD ring\n");
@@ -2400,10 +2739,12 @@ __attribute__((cold)) void pfe_hif_chnl_destroy(pfe_hif_chnl_t *chnl)
 			NXP_LOG_WARNING("Could not properly destroy channel mutex\n");
 		}
 
+#if (FALSE == PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER)
 		if (EOK != oal_spinlock_destroy(&chnl->rx_lock))
 		{
 			NXP_LOG_WARNING("Could not properly destroy channel RX mutex\n");
 		}
+#endif /* PFE_HIF_CHNL_CFG_RX_SINGLE_CONSUMER */
 
 #if defined(PFE_CFG_HIF_TX_FIFO_FIX)
 		cbc_lock_initialized--;
@@ -30,9 +30,6 @@
 #include "pfe_cbus.h"
 #include "pfe_hif_ring.h"
 
-#define RING_LEN						PFE_HIF_RING_CFG_LENGTH
-#define RING_LEN_MASK					(PFE_HIF_RING_CFG_LENGTH - 1U)
-
 /* Buffer descriptor WORD0 */
 #define HIF_RING_BD_W0_DESC_EN				(1U << 31U)
 /* 30 .. 21 reserved */
@@ -219,23 +216,36 @@ typedef struct __attribute__((packed)) pfe_hif_wb_bd_tag
 
 /**
  * @brief	The BD ring structure
- * @note	The attribute 'aligned' is here just to ensure proper alignment
+ * @details	Producer ('enqueue') and consumer ('dequeue') state live in separate
+ * 			cache lines. The two sides typically run on different CPUs (xmit vs.
+ * 			TX confirmation, RX refill vs. RX poll) and would otherwise invalidate
+ * 			each other's line on every BD. Each side keeps a shadow copy of the
+ * 			other side's index and reads the real one only when the shadow
+ * 			does not give the answer.
+ * @note	The attribute 'aligned' is here also to ensure proper alignment
  * 			when instance will be created automatically without dynamic memory
  * 			allocation.
  */
-struct __attribute__((aligned (HAL_CACHE_LINE_SIZE), packed)) pfe_hif_ring_tag
+struct __attribute__((aligned (HAL_CACHE_LINE_SIZE))) pfe_hif_ring_tag
 {
-	/*	Put often used data from beginning to improve cache locality */
-
-	/*	Every 'enqueue' and 'dequeue' access */
+	/*	Read-only once the ring is created, accessed by both sides */
 	void *base_va;				/*	Ring base address (virtual) */
 	void *wb_tbl_base_va;		/*	Write-back table base address (virtual) */
+	uint32_t len;				/*	Number of entries, power of 2 */
+	uint32_t len_mask;			/*	Index mask (len - 1) */
+	bool_t is_rx;				/*	If TRUE then ring is RX ring */
+	bool_t is_nocpy;			/*	If TRUE then ring is HIF NOCPY variant */
+
+	/*	Initialization time only */
+	void *base_pa;				/*	Ring base address (physical) */
+	void *wb_tbl_base_pa;		/*	Write-back table base address (physical) */
+
+	/*	Every 'enqueue' access */
+	uint32_t write_idx __attribute__((aligned (HAL_CACHE_LINE_SIZE)));	/*	BD index to be written */
+	uint32_t rd_idx_shadow;		/*	Last read_idx seen by the producer */
 #ifdef PFE_CFG_HIF_SEQNUM_CHECK
 	uint16_t seqnum;			/*	Current sequence number */
 #endif /* PFE_CFG_HIF_SEQNUM_CHECK */
-
-	/*	Every 'enqueue' access */
-	uint32_t write_idx;			/*	BD index to be written */
 	union						/* Pointer to BD to be written */
 	{
 		pfe_hif_bd_t *wr_bd;
@@ -254,11 +264,10 @@ struct __attribute__((aligned (HAL_CACHE_LINE_SIZE), packed)) pfe_hif_ring_tag
 	};
 #endif /* HAL_HANDLE_CACHE */
 	pfe_hif_wb_bd_t *wr_wb_bd;	/*	Pointer to WB BD to be written */
-	bool_t is_rx;				/*	If TRUE then ring is RX ring */
-	bool_t is_nocpy;			/*	If TRUE then ring is HIF NOCPY variant */
 
 	/*	Every 'dequeue' access */
-	uint32_t read_idx;			/*	BD index to be read */
+	uint32_t read_idx __attribute__((aligned (HAL_CACHE_LINE_SIZE)));	/*	BD index to be read */
+	uint32_t wr_idx_shadow;		/*	Last write_idx seen by the consumer */
 	union						/*	Pointer to BD to be read */
 	{
 		pfe_hif_bd_t *rd_bd;
@@ -268,17 +277,12 @@ struct __attribute__((aligned (HAL_CACHE_LINE_SIZE), packed)) pfe_hif_ring_tag
 	};
 
 	pfe_hif_wb_bd_t *rd_wb_bd;	/*	Pointer to WB BD to be read */
-	bool_t heavy_data_mark;		/*	To enable getting size of heavily accessed data */
-
-	/*	Initialization time only */
-	void *base_pa;				/*	Ring base address (physical) */
-	void *wb_tbl_base_pa;		/*	Write-back table base address (physical) */
 };
 
 __attribute__((hot)) static inline void inc_write_index_std(pfe_hif_ring_t *ring);
 __attribute__((hot)) static inline void dec_write_index_std(pfe_hif_ring_t *ring);
 __attribute__((hot)) static inline void inc_read_index_std(pfe_hif_ring_t *ring);
-__attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t seqnum, bool_t rx);
+__attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t seqnum, bool_t rx, uint32_t len);
 static inline errno_t pfe_hif_ring_enqueue_buf_std(pfe_hif_ring_t *ring, const void *buf_pa, uint32_t length, bool_t lifm);
 static inline errno_t pfe_hif_ring_dequeue_buf_std(pfe_hif_ring_t *ring, void **buf_pa, uint32_t *length, bool_t *lifm);
 #ifdef PFE_CFG_HIF_TX_FIFO_FIX
@@ -290,7 +294,7 @@ __attribute__((cold)) static void pfe_hif_ring_invalidate_std(const pfe_hif_ring
 #if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
 __attribute__((hot)) static inline void inc_write_index_nocpy(pfe_hif_ring_t *ring);
 __attribute__((hot)) static inline void inc_read_index_nocpy(pfe_hif_ring_t *ring);
-__attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_nocpy(uint16_t seqnum, bool_t rx);
+__attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_nocpy(uint16_t seqnum, bool_t rx, uint32_t len);
 static inline errno_t pfe_hif_ring_enqueue_buf_nocpy(pfe_hif_ring_t *ring, void *buf_pa, uint32_t length, bool_t lifm);
 static inline errno_t pfe_hif_ring_dequeue_buf_nocpy(pfe_hif_ring_t *ring, void **buf_pa, uint32_t *length, bool_t *lifm);
 #ifdef PFE_CFG_HIF_TX_FIFO_FIX
@@ -304,37 +308,37 @@ __attribute__((cold)) static void pfe_hif_ring_invalidate_nocpy(pfe_hif_ring_t *
 __attribute__((hot)) static inline void inc_write_index_std(pfe_hif_ring_t *ring)
 {
 	ring->write_idx++;
-	ring->wr_bd = &((pfe_hif_bd_t *)ring->base_va)[ring->write_idx & RING_LEN_MASK];
-	ring->wr_wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ring->write_idx & RING_LEN_MASK];
+	ring->wr_bd = &((pfe_hif_bd_t *)ring->base_va)[ring->write_idx & ring->len_mask];
+	ring->wr_wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ring->write_idx & ring->len_mask];
 }
 
 __attribute__((hot)) static inline void dec_write_index_std(pfe_hif_ring_t *ring)
 {
 	ring->write_idx--;
-	ring->wr_bd = &((pfe_hif_bd_t *)ring->base_va)[ring->write_idx & RING_LEN_MASK];
-	ring->wr_wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ring->write_idx & RING_LEN_MASK];
+	ring->wr_bd = &((pfe_hif_bd_t *)ring->base_va)[ring->write_idx & ring->len_mask];
+	ring->wr_wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ring->write_idx & ring->len_mask];
 }
 
 #if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
 __attribute__((hot)) static inline void inc_write_index_nocpy(pfe_hif_ring_t *ring)
 {
 	ring->write_idx++;
-	ring->wr_bd_nocpy = &((pfe_hif_nocpy_bd_t *)ring->base_va)[ring->write_idx & RING_LEN_MASK];
+	ring->wr_bd_nocpy = &((pfe_hif_nocpy_bd_t *)ring->base_va)[ring->write_idx & ring->len_mask];
 }
 #endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
 
 __attribute__((hot)) static inline void inc_read_index_std(pfe_hif_ring_t *ring)
 {
 	ring->read_idx++;
-	ring->rd_bd = &((pfe_hif_bd_t *)ring->base_va)[ring->read_idx & RING_LEN_MASK];
-	ring->rd_wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ring->read_idx & RING_LEN_MASK];
+	ring->rd_bd = &((pfe_hif_bd_t *)ring->base_va)[ring->read_idx & ring->len_mask];
+	ring->rd_wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ring->read_idx & ring->len_mask];
 }
 
 #if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
 __attribute__((hot)) static inline void inc_read_index_nocpy(pfe_hif_ring_t *ring)
 {
 	ring->read_idx++;
-	ring->rd_bd_nocpy = &((pfe_hif_nocpy_bd_t *)ring->base_va)[ring->read_idx & RING_LEN_MASK];
+	ring->rd_bd_nocpy = &((pfe_hif_nocpy_bd_t *)ring->base_va)[ring->read_idx & ring->len_mask];
 }
 #endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
 
@@ -357,7 +361,7 @@ __attribute__((pure, hot)) bool_t pfe_hif_ring_is_below_wm(const pfe_hif_ring_t
 #endif /* PFE_CFG_NULL_ARG_CHECK */
 
 	/*	TODO: Make the water-mark value configurable */
-	if (pfe_hif_ring_get_fill_level(ring) >= (RING_LEN / 2))
+	if (pfe_hif_ring_get_fill_level(ring) >= (ring->len / 2))
 	{
 		return TRUE;
 	}
@@ -379,7 +383,7 @@ __attribute__((pure, hot)) uint32_t pfe_hif_ring_get_fill_level(const pfe_hif_ri
 	if (unlikely(NULL == ring))
 	{
 		NXP_LOG_ERROR("NULL argument received\n");
-		return RING_LEN;
+		return PFE_HIF_RING_CFG_LENGTH_MAX;
 	}
 #endif /* PFE_CFG_NULL_ARG_CHECK */
 
@@ -399,6 +403,81 @@ __attribute__((pure, hot)) uint32_t pfe_hif_ring_get_fill_level(const pfe_hif_ri
 	}
 }
 
+/**
+ * @brief		Check if the ring can take number of buffers
+ * @details		Producer side check. The consumer index is read only when the
+ * 				shadow copy is not enough to accept the buffers.
+ * @param[in]	ring The ring instance
+ * @param[in]	num Number of buffers
+ * @return		TRUE if 'num' buffers can be enqueued
+ * @note		Must not be preempted by: pfe_hif_ring_destroy()
+ */
+__attribute__((hot)) bool_t pfe_hif_ring_can_enqueue(pfe_hif_ring_t *ring, uint32_t num)
+{
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely(NULL == ring))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return FALSE;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	/*	HIF NOCPY RX ring is never filled by SW, see pfe_hif_ring_get_fill_level() */
+	if ((ring->is_nocpy) && (ring->is_rx))
+	{
+		return TRUE;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+	/*	A single entry must remain unused within the ring because HIF expects that */
+	if ((ring->len - 1U - (ring->write_idx - ring->rd_idx_shadow)) >= num)
+	{
+		return TRUE;
+	}
+
+	/*	Consumer may have moved meanwhile */
+	ring->rd_idx_shadow = ring->read_idx;
+
+	return ((ring->len - 1U - (ring->write_idx - ring->rd_idx_shadow)) >= num);
+}
+
+/**
+ * @brief		Check if the ring is empty
+ * @details		Consumer side check. The producer index is read only when the
+ * 				shadow copy says all enqueued entries were dequeued.
+ * @param[in]	ring The ring instance
+ * @return		TRUE if there is no enqueued entry
+ * @note		Must not be preempted by: pfe_hif_ring_destroy()
+ */
+__attribute__((hot)) bool_t pfe_hif_ring_is_empty(pfe_hif_ring_t *ring)
+{
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely(NULL == ring))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return TRUE;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	if ((ring->is_nocpy) && (ring->is_rx))
+	{
+		return TRUE;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+	if (ring->read_idx != ring->wr_idx_shadow)
+	{
+		return FALSE;
+	}
+
+	/*	Producer may have moved meanwhile */
+	ring->wr_idx_shadow = ring->write_idx;
+
+	return (ring->read_idx == ring->wr_idx_shadow);
+}
+
 /**
  * @brief		Get physical address of the start of the ring
  * @param[in]	ring The ring instance
@@ -468,11 +547,15 @@ __attribute__((pure, cold)) uint32_t pfe_hif_ring_get_wb_tbl_len(const pfe_hif_r
 		/*	NOCPY ring does not use write-back descriptors */
 		return 0U;
 	}
-#else /* PFE_CFG_HIF_NOCPY_SUPPORT */
-    (void)ring;
+#elif defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely(NULL == ring))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return 0U;
+	}
 #endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
 
-	return RING_LEN;
+	return ring->len;
 }
 
 /**
@@ -489,11 +572,9 @@ __attribute__((pure, hot)) uint32_t pfe_hif_ring_get_len(const pfe_hif_ring_t *r
 		NXP_LOG_ERROR("NULL argument received\n");
 		return 0U;
 	}
-#else 
-    (void)ring;
 #endif /* PFE_CFG_NULL_ARG_CHECK */
 
-	return RING_LEN;
+	return ring->len;
 }
 
 /**
@@ -532,6 +613,203 @@ __attribute__((hot)) errno_t pfe_hif_ring_enqueue_buf(pfe_hif_ring_t *ring, cons
 	}
 }
 
+/**
+ * @brief		Add batch of empty RX buffers to the ring
+ * @details		All buffers are of the same length and each one is marked as
+ * 				last-in-frame. Write-back descriptors of the whole batch are
+ * 				enabled first and a single barrier is issued before the BDs are
+ * 				handed over to the HW. Write index is updated once. Enqueuing
+ * 				stops at the first BD which is still in use.
+ * @param[in]	ring The RX ring instance
+ * @param[in]	buf_pa Array of physical addresses of the buffers
+ * @param[in]	length Length of each buffer
+ * @param[in]	count Number of buffers in the array
+ * @return		Number of buffers added to the ring
+ * @note		Must not be preempted by: pfe_hif_ring_destroy()
+ */
+__attribute__((hot)) uint32_t pfe_hif_ring_enqueue_rx_bufs(pfe_hif_ring_t *ring, const void *const *buf_pa, uint32_t length, uint32_t count)
+{
+	pfe_hif_bd_t *bd;
+	uint32_t ii, tmp_ctrl_seq_w0;
+
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely((NULL == ring) || (NULL == buf_pa)))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return 0U;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	if (ring->is_nocpy)
+	{
+		/*	There is nothing to enqueue into RX ring in case of HIF NOCPY */
+		return 0U;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+	for (ii = 0U; ii < count; ii++)
+	{
+		bd = &((pfe_hif_bd_t *)ring->base_va)[(ring->write_idx + ii) & ring->len_mask];
+		if (unlikely(0U != (bd->ctrl_seqnum_w0 & HIF_RING_BD_W0_DESC_EN)))
+		{
+			break;
+		}
+
+		bd->data = (uint32_t)(addr_t)buf_pa[ii];
+		bd->rsvd_buflen_w1 = HIF_RING_BD_W1_BD_RSVD_STAT(0U) |
+							 HIF_RING_BD_W1_BD_BUFFLEN((uint16_t)length);
+		((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[(ring->write_idx + ii) & ring->len_mask].rsvd_ctrl_w0 |= HIF_RING_WB_BD_W0_DESC_EN;
+	}
+
+	count = ii;
+	if (0U == count)
+	{
+		return 0U;
+	}
+
+	/*	Wait until all WB BDs and BD data are written */
+	hal_wmb();
+
+	for (ii = 0U; ii < count; ii++)
+	{
+		bd = &((pfe_hif_bd_t *)ring->base_va)[(ring->write_idx + ii) & ring->len_mask];
+		tmp_ctrl_seq_w0 = bd->ctrl_seqnum_w0 | HIF_RING_BD_W0_LIFM;
+#ifdef PFE_CFG_HIF_SEQNUM_CHECK
+		tmp_ctrl_seq_w0 &= ~(HIF_RING_BD_W0_BD_SEQNUM_MASK << HIF_RING_BD_W0_BD_SEQNUM_OFFSET);
+		tmp_ctrl_seq_w0 |= HIF_RING_BD_W0_BD_SEQNUM(ring->seqnum);
+		ring->seqnum++;
+#endif /* PFE_CFG_HIF_SEQNUM_CHECK */
+		bd->ctrl_seqnum_w0 = (tmp_ctrl_seq_w0 | HIF_RING_BD_W0_DESC_EN);
+	}
+
+	/*	Move the write pointer past the batch */
+	ring->write_idx += count;
+	ring->wr_bd = &((pfe_hif_bd_t *)ring->base_va)[ring->write_idx & ring->len_mask];
+	ring->wr_wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ring->write_idx & ring->len_mask];
+
+	return count;
+}
+
+/**
+ * @brief		Add burst of buffers to the ring
+ * @details		Either all buffers are enqueued or none, so a frame is never
+ * 				handed over to the HW partially. Data and length of all BDs and
+ * 				the write-back BDs are written first, a single barrier is issued
+ * 				and then the BDs are enabled in ring order. Write index is updated
+ * 				once.
+ * @param[in]	ring The ring instance
+ * @param[in]	bufs Array of buffers. The last buffer of each frame shall have lifm set.
+ * @param[in]	count Number of buffers in the array
+ * @retval		EOK Success
+ * @retval		ENOSPC Not enough free BDs for the whole burst
+ * @retval		EPERM Ring does not accept enqueue requests
+ * @note		Must not be preempted by: pfe_hif_ring_destroy()
+ */
+__attribute__((hot)) errno_t pfe_hif_ring_enqueue_bufs(pfe_hif_ring_t *ring, const pfe_hif_ring_buf_t *bufs, uint32_t count)
+{
+	pfe_hif_bd_t *bd;
+	uint32_t ii, idx, tmp_ctrl_seq_w0;
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	pfe_hif_nocpy_bd_t *bd_nocpy;
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely((NULL == ring) || (NULL == bufs)))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return EINVAL;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	if (unlikely((ring->is_nocpy) && (ring->is_rx)))
+	{
+		NXP_LOG_ERROR("There is nothing to enqueue into RX ring in case of HIF NOCPY\n");
+		return EPERM;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+	if (unlikely(FALSE == pfe_hif_ring_can_enqueue(ring, count)))
+	{
+		return ENOSPC;
+	}
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	if (ring->is_nocpy)
+	{
+		/*	Same as for the standard BDs, nothing is enabled until all BDs are written.
+			Egress interface of direct mode is set by pfe_hif_ring_set_egress_if(). */
+		for (ii = 0U; ii < count; ii++)
+		{
+			bd_nocpy = &((pfe_hif_nocpy_bd_t *)ring->base_va)[(ring->write_idx + ii) & ring->len_mask];
+			bd_nocpy->data = (uint32_t)((addr_t)bufs[ii].buf_pa & 0xffffffffU);
+			bd_nocpy->tx_buflen = (uint16_t)bufs[ii].len;
+			bd_nocpy->tx_status = 0xf0U; /* This is from reference code. Not documented. */
+			bd_nocpy->tx_queueno = 0U;
+			bd_nocpy->lmem_cpy = 0U;
+			bd_nocpy->lifm = (bufs[ii].lifm) ? 1U : 0U;
+		}
+
+		/*	Wait until all BDs are written */
+		hal_wmb();
+
+		for (ii = 0U; ii < count; ii++)
+		{
+			((pfe_hif_nocpy_bd_t *)ring->base_va)[(ring->write_idx + ii) & ring->len_mask].desc_en = 1U;
+		}
+
+		/*	Move the write pointer past the burst */
+		ring->write_idx += count;
+		ring->wr_bd_nocpy = &((pfe_hif_nocpy_bd_t *)ring->base_va)[ring->write_idx & ring->len_mask];
+
+		return EOK;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+	for (ii = 0U; ii < count; ii++)
+	{
+		idx = (ring->write_idx + ii) & ring->len_mask;
+		bd = &((pfe_hif_bd_t *)ring->base_va)[idx];
+		bd->data = (uint32_t)(addr_t)bufs[ii].buf_pa;
+		bd->rsvd_buflen_w1 = HIF_RING_BD_W1_BD_RSVD_STAT(0U) |
+							 HIF_RING_BD_W1_BD_BUFFLEN((uint16_t)bufs[ii].len);
+		((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[idx].rsvd_ctrl_w0 |= HIF_RING_WB_BD_W0_DESC_EN;
+	}
+
+	/*	Wait until all WB BDs and BD data are written */
+	hal_wmb();
+
+	for (ii = 0U; ii < count; ii++)
+	{
+		bd = &((pfe_hif_bd_t *)ring->base_va)[(ring->write_idx + ii) & ring->len_mask];
+		tmp_ctrl_seq_w0 = bd->ctrl_seqnum_w0;
+
+		if (bufs[ii].lifm)
+		{
+			tmp_ctrl_seq_w0 |= HIF_RING_BD_W0_LIFM;
+		}
+		else
+		{
+			tmp_ctrl_seq_w0 &= ~HIF_RING_BD_W0_LIFM;
+		}
+
+#ifdef PFE_CFG_HIF_SEQNUM_CHECK
+		tmp_ctrl_seq_w0 &= ~(HIF_RING_BD_W0_BD_SEQNUM_MASK << HIF_RING_BD_W0_BD_SEQNUM_OFFSET);
+		tmp_ctrl_seq_w0 |= HIF_RING_BD_W0_BD_SEQNUM(ring->seqnum);
+		ring->seqnum++;
+#endif /* PFE_CFG_HIF_SEQNUM_CHECK */
+		bd->ctrl_seqnum_w0 = (tmp_ctrl_seq_w0 | HIF_RING_BD_W0_DESC_EN);
+	}
+
+	/*	Move the write pointer past the burst */
+	ring->write_idx += count;
+	ring->wr_bd = &((pfe_hif_bd_t *)ring->base_va)[ring->write_idx & ring->len_mask];
+	ring->wr_wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ring->write_idx & ring->len_mask];
+
+	return EOK;
+}
+
 #if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
 #if defined(PFE_CFG_HIF_NOCPY_DIRECT)
 /**
@@ -681,7 +959,7 @@ static inline errno_t pfe_hif_ring_enqueue_buf_std(pfe_hif_ring_t *ring, const v
 		if (ring->is_rx)
 		{
 			NXP_LOG_INFO("EQ: IDX:%02d, BD@p0x%p, WB@p0x%p, BUF@p0x%p\n",
-				(ring->write_idx & RING_LEN_MASK),
+				(ring->write_idx & ring->len_mask),
 				(void *)((addr_t)ring->wr_bd - ((addr_t)ring->base_va - (addr_t)ring->base_pa)),
 				(void *)((addr_t)ring->wr_wb_bd - ((addr_t)ring->wb_tbl_base_va - (addr_t)ring->wb_tbl_base_pa)),
 				(void *)buf_pa);
@@ -835,7 +1113,7 @@ static inline errno_t pfe_hif_ring_dequeue_buf_std(pfe_hif_ring_t *ring, void **
 		if (ring->is_rx)
 		{
 			NXP_LOG_INFO("DQ: IDX:%02d, BD@p0x%p, WB@p0x%p, BUF@p0x%p\n",
-				(ring->read_idx & RING_LEN_MASK),
+				(ring->read_idx & ring->len_mask),
 				(void *)((addr_t)ring->rd_bd - ((addr_t)ring->base_va - (addr_t)ring->base_pa)),
 				(void *)((addr_t)ring->rd_wb_bd - ((addr_t)ring->wb_tbl_base_va - (addr_t)ring->wb_tbl_base_pa)),
 				(void *)*buf_pa);
@@ -851,6 +1129,98 @@ static inline errno_t pfe_hif_ring_dequeue_buf_std(pfe_hif_ring_t *ring, void **
 	return EOK;
 }
 
+/**
+ * @brief		Dequeue burst of buffers from the ring
+ * @details		Remove up to count processed buffers from the ring. Dequeuing stops
+ * 				at the first BD still owned by the HW. The following BD and write-back
+ * 				BD are prefetched while the current one is processed and the read
+ * 				index is updated once for the whole burst.
+ * @param[in]	ring The ring instance
+ * @param[out]	bufs Array where the dequeued buffers shall be written
+ * @param[in]	count Size of the array
+ * @return		Number of dequeued buffers
+ * @note		Must not be preempted by: pfe_hif_ring_destroy()
+ */
+__attribute__((hot)) uint32_t pfe_hif_ring_dequeue_bufs(pfe_hif_ring_t *ring, pfe_hif_ring_buf_t *bufs, uint32_t count)
+{
+	pfe_hif_bd_t *bd;
+	pfe_hif_wb_bd_t *wb_bd;
+	uint32_t ii, idx;
+	uint32_t tmp_bd_ctrl_seq_w0;
+	uint32_t tmp_wb_bd_ctrl_w0;
+	uint32_t tmp_wb_bd_seq_buf_w1;
+
+#if defined(PFE_CFG_NULL_ARG_CHECK)
+	if (unlikely((NULL == ring) || (NULL == bufs)))
+	{
+		NXP_LOG_ERROR("NULL argument received\n");
+		return 0U;
+	}
+#endif /* PFE_CFG_NULL_ARG_CHECK */
+
+#if defined(PFE_CFG_HIF_NOCPY_SUPPORT)
+	if (ring->is_nocpy)
+	{
+		for (ii = 0U; ii < count; ii++)
+		{
+			if (EOK != pfe_hif_ring_dequeue_buf_nocpy(ring, &bufs[ii].buf_pa, &bufs[ii].len, &bufs[ii].lifm))
+			{
+				break;
+			}
+		}
+
+		return ii;
+	}
+#endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
+
+	for (ii = 0U; ii < count; ii++)
+	{
+		idx = (ring->read_idx + ii) & ring->len_mask;
+		bd = &((pfe_hif_bd_t *)ring->base_va)[idx];
+		wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[idx];
+
+		tmp_wb_bd_ctrl_w0 = wb_bd->rsvd_ctrl_w0;
+		if (0U != (tmp_wb_bd_ctrl_w0 & HIF_RING_WB_BD_W0_DESC_EN))
+		{
+			/*	Still used by HW */
+			break;
+		}
+
+		/*	Fetch the next descriptors while this one is processed */
+		__builtin_prefetch(&((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[(idx + 1U) & ring->len_mask]);
+		__builtin_prefetch(&((pfe_hif_bd_t *)ring->base_va)[(idx + 1U) & ring->len_mask]);
+
+		tmp_bd_ctrl_seq_w0 = bd->ctrl_seqnum_w0;
+		tmp_wb_bd_seq_buf_w1 = wb_bd->seqnum_buflen_w1;
+
+		if ((0U == (tmp_bd_ctrl_seq_w0 & HIF_RING_BD_W0_DESC_EN))
+#ifdef PFE_CFG_HIF_SEQNUM_CHECK
+			|| (HIF_RING_WB_BD_W1_WB_BD_SEQNUM_GET(tmp_wb_bd_seq_buf_w1) != HIF_RING_BD_W0_BD_SEQNUM_GET(tmp_bd_ctrl_seq_w0))
+#endif /* PFE_CFG_HIF_SEQNUM_CHECK */
+			)
+		{
+			break;
+		}
+
+		/*	Reset BD EN flag so it is not reused by HW */
+		bd->ctrl_seqnum_w0 = (tmp_bd_ctrl_seq_w0 & ~HIF_RING_BD_W0_DESC_EN);
+
+		bufs[ii].buf_pa = (void *)(addr_t)(bd->data);
+		bufs[ii].len = HIF_RING_WB_BD_W1_WB_BD_BUFFLEN_GET(tmp_wb_bd_seq_buf_w1);
+		bufs[ii].lifm = (0U != (tmp_wb_bd_ctrl_w0 & HIF_RING_WB_BD_W0_LIFM));
+	}
+
+	if (ii > 0U)
+	{
+		/*	Move the read pointer past the burst */
+		ring->read_idx += ii;
+		ring->rd_bd = &((pfe_hif_bd_t *)ring->base_va)[ring->read_idx & ring->len_mask];
+		ring->rd_wb_bd = &((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ring->read_idx & ring->len_mask];
+	}
+
+	return ii;
+}
+
 /**
  * @brief		Dequeue buffer from the ring without response
  * @details		Remove next buffer from the ring and increment the read index. If the
@@ -1106,6 +1476,10 @@ __attribute__((cold)) errno_t pfe_hif_ring_drain_buf(pfe_hif_ring_t *ring, void
 		return ENOENT;
 	}
 
+	/*	Draining moves both indices, the write one even backwards */
+	ring->rd_idx_shadow = ring->read_idx;
+	ring->wr_idx_shadow = ring->write_idx;
+
 	return EOK;
 }
 
@@ -1155,7 +1529,7 @@ __attribute__((cold)) static void pfe_hif_ring_invalidate_nocpy(pfe_hif_ring_t *
 	}
 #endif /* PFE_CFG_NULL_ARG_CHECK */
 
-	for (ii=0U; ii<RING_LEN; ii++)
+	for (ii=0U; ii<ring->len; ii++)
 	{
 		/*	Zero-out the EN flag */
 		(((pfe_hif_nocpy_bd_t *)ring->base_va)[ii]).desc_en = 0U;
@@ -1181,7 +1555,7 @@ __attribute__((cold)) static void pfe_hif_ring_invalidate_std(const pfe_hif_ring
 	}
 #endif /* PFE_CFG_NULL_ARG_CHECK */
 
-	for (ii=0U; ii<RING_LEN; ii++)
+	for (ii=0U; ii<ring->len; ii++)
 	{
 		/*	Mark the descriptor as last BD and set enable flag */
 		(((pfe_hif_bd_t *)ring->base_va)[ii]).ctrl_seqnum_w0 &= ~HIF_RING_BD_W0_DESC_EN;
@@ -1218,16 +1592,16 @@ __attribute__((cold)) uint32_t pfe_hif_ring_dump(pfe_hif_ring_t *ring, char_t *n
 	}
 #endif /* PFE_CFG_NULL_ARG_CHECK */
 
-	len += (uint32_t)oal_util_snprintf(buf + len, size - len, "Ring %s: len %d\n", name, RING_LEN);
+	len += (uint32_t)oal_util_snprintf(buf + len, size - len, "Ring %s: len %d\n", name, ring->len);
 	len += (uint32_t)oal_util_snprintf(buf + len, size - len, "  Type: %s\n", ring->is_rx ? "RX" : "TX");
-	len += (uint32_t)oal_util_snprintf(buf + len, size - len, "  Index w/r: %d/%d (%d/%d)\n", ring->write_idx & RING_LEN_MASK, ring->read_idx & RING_LEN_MASK, ring->write_idx, ring->read_idx);
+	len += (uint32_t)oal_util_snprintf(buf + len, size - len, "  Index w/r: %d/%d (%d/%d)\n", ring->write_idx & ring->len_mask, ring->read_idx & ring->len_mask, ring->write_idx, ring->read_idx);
 #ifdef PFE_CFG_HIF_SEQNUM_CHECK
 	len += (uint32_t)oal_util_snprintf(buf + len, size - len, "  Seqn: 0x%x\n", ring->seqnum);
 #endif /* PFE_CFG_HIF_SEQNUM_CHECK */
 
 	if(verb_level >= 8) {
 		/* BD ring */
-		for (ii=0U; ii<RING_LEN; ii++)
+		for (ii=0U; ii<ring->len; ii++)
 		{
 
 			pfe_hif_bd_t *bd = &(((pfe_hif_bd_t *)ring->base_va)[ii]);
@@ -1237,11 +1611,11 @@ __attribute__((cold)) uint32_t pfe_hif_ring_dump(pfe_hif_ring_t *ring, char_t *n
 				len += (uint32_t)oal_util_snprintf(buf + len, size - len, "            pa           idx: bufl:ctrl: status :  data  :  next  :seqn\n");
 			}
 
-			if ((ring->write_idx & RING_LEN_MASK) == ii)
+			if ((ring->write_idx & ring->len_mask) == ii)
 			{
 				idx_str = "<-- WR";
 			}
-			else if ((ring->read_idx & RING_LEN_MASK) == ii)
+			else if ((ring->read_idx & ring->len_mask) == ii)
 			{
 				idx_str = "<-- RD";
 			}
@@ -1258,7 +1632,7 @@ __attribute__((cold)) uint32_t pfe_hif_ring_dump(pfe_hif_ring_t *ring, char_t *n
 		if (FALSE == ring->is_nocpy)
 #endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
 		{
-			for (ii=0U; ii<RING_LEN; ii++)
+			for (ii=0U; ii<ring->len; ii++)
 			{
 				pfe_hif_wb_bd_t *wb = &(((pfe_hif_wb_bd_t *)ring->wb_tbl_base_va)[ii]);
 				if (0 == ii)
@@ -1267,7 +1641,7 @@ __attribute__((cold)) uint32_t pfe_hif_ring_dump(pfe_hif_ring_t *ring, char_t *n
 					len += (uint32_t)oal_util_snprintf(buf + len, size - len, "    pa:      idx:  ctl: rsvd :bufl:seqn\n");
 				}
 
-				if ((ring->read_idx & RING_LEN_MASK) == ii)
+				if ((ring->read_idx & ring->len_mask) == ii)
 				{
 					idx_str = "<-- RD";
 				}
@@ -1289,11 +1663,19 @@ __attribute__((cold)) uint32_t pfe_hif_ring_dump(pfe_hif_ring_t *ring, char_t *n
  * @param[in]	rx If TRUE the ring is RX, if FALSE the the ring is TX
  * @param[in]	seqnum Initial sequence number
  * @param[in]	nocpy If TRUE then ring will be treated as HIF NOCPY variant
+ * @param[in]	len Number of ring entries. Power of 2 within PFE_HIF_RING_CFG_LENGTH_MIN
+ *				and PFE_HIF_RING_CFG_LENGTH_MAX.
  * @return		The new ring instance or NULL if the call has failed
  * @note		Must not be preempted by any of the remaining API functions
  */
-__attribute__((cold)) pfe_hif_ring_t *pfe_hif_ring_create(bool_t rx, uint16_t seqnum, bool_t nocpy)
+__attribute__((cold)) pfe_hif_ring_t *pfe_hif_ring_create(bool_t rx, uint16_t seqnum, bool_t nocpy, uint32_t len)
 {
+	if ((len < PFE_HIF_RING_CFG_LENGTH_MIN) || (len > PFE_HIF_RING_CFG_LENGTH_MAX) || (0U != (len & (len - 1U))))
+	{
+		NXP_LOG_ERROR("Unsupported ring length: %u\n", (uint_t)len);
+		return NULL;
+	}
+
 #if !defined(PFE_CFG_HIF_NOCPY_SUPPORT)
 	if (TRUE == nocpy)
 	{
@@ -1303,12 +1685,12 @@ __attribute__((cold)) pfe_hif_ring_t *pfe_hif_ring_create(bool_t rx, uint16_t se
 #else
 	if (TRUE == nocpy)
 	{
-		return pfe_hif_ring_create_nocpy(seqnum, rx);
+		return pfe_hif_ring_create_nocpy(seqnum, rx, len);
 	}
 	else
 #endif /* PFE_CFG_HIF_NOCPY_SUPPORT */
 	{
-		return pfe_hif_ring_create_std(seqnum, rx);
+		return pfe_hif_ring_create_std(seqnum, rx, len);
 	}
 }
 
@@ -1316,7 +1698,7 @@ __attribute__((cold)) pfe_hif_ring_t *pfe_hif_ring_create(bool_t rx, uint16_t se
 /**
  * @brief		The HIF NOCPY variant
  */
-__attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_nocpy(uint16_t seqnum, bool_t rx)
+__attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_nocpy(uint16_t seqnum, bool_t rx, uint32_t len)
 {
 	pfe_hif_ring_t *ring;
 	uint32_t ii, size;
@@ -1338,12 +1720,8 @@ __attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_nocpy(uint16_t
 	ring->wb_tbl_base_pa = NULL;
 	ring->rd_wb_bd = NULL;
 	ring->is_nocpy = TRUE;
-
-	/*	Just a debug check */
-	if (((addr_t)&ring->heavy_data_mark - (addr_t)ring) > HAL_CACHE_LINE_SIZE)
-	{
-		NXP_LOG_DEBUG("Suboptimal: Data split between two cache lines\n");
-	}
+	ring->len = len;
+	ring->len_mask = len - 1U;
 
 	/*	Allocate memory for buffer descriptors. Should be DMA safe, contiguous, and 64-bit aligned. */
 	if (0 != (HAL_CACHE_LINE_SIZE % 8))
@@ -1356,7 +1734,7 @@ __attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_nocpy(uint16_t
 		ii = HAL_CACHE_LINE_SIZE;
 	}
 
-	size = RING_LEN * sizeof(pfe_hif_nocpy_bd_t);
+	size = ring->len * sizeof(pfe_hif_nocpy_bd_t);
 	ring->base_va = oal_mm_malloc_contig_aligned_nocache(size, ii);
 
 	if (unlikely(NULL == ring->base_va))
@@ -1386,18 +1764,20 @@ __attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_nocpy(uint16_t
 	/*	Initialize state variables */
 	ring->write_idx = 0U;
 	ring->read_idx = 0U;
+	ring->rd_idx_shadow = 0U;
+	ring->wr_idx_shadow = 0U;
 	ring->is_rx = rx;
 	ring->rd_bd_nocpy = (pfe_hif_nocpy_bd_t *)ring->base_va;
 	ring->wr_bd_nocpy = (pfe_hif_nocpy_bd_t *)ring->base_va;
 
 	/*	Initialize memory */
-	memset(ring->base_va, 0, RING_LEN * sizeof(pfe_hif_nocpy_bd_t));
+	memset(ring->base_va, 0, ring->len * sizeof(pfe_hif_nocpy_bd_t));
 
 	/*	Chain the buffer descriptors */
 	hw_desc_va = (pfe_hif_nocpy_bd_t *)ring->base_va;
 	hw_desc_pa = (pfe_hif_nocpy_bd_t *)ring->base_pa;
 
-	for (ii=0; ii<RING_LEN; ii++)
+	for (ii=0; ii<ring->len; ii++)
 	{
 		if (TRUE == ring->is_rx)
 		{
@@ -1433,7 +1813,7 @@ free_and_fail:
 /**
  * @brief		The "standard" HIF variant
  */
-__attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t seqnum, bool_t rx)
+__attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t seqnum, bool_t rx, uint32_t len)
 {
 	pfe_hif_ring_t *ring;
 	uint32_t ii, size;
@@ -1458,12 +1838,8 @@ __attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t se
 	ring->base_va = NULL;
 	ring->wb_tbl_base_va = NULL;
 	ring->is_nocpy = FALSE;
-
-	/*	Just a debug check */
-	if (((addr_t)&ring->heavy_data_mark - (addr_t)ring) > HAL_CACHE_LINE_SIZE)
-	{
-		NXP_LOG_DEBUG("Suboptimal: Data split between two cache lines\n");
-	}
+	ring->len = len;
+	ring->len_mask = len - 1U;
 
 	/*	Allocate memory for buffer descriptors. Should be DMA safe, contiguous, and 64-bit aligned. */
 	if (0 != (HAL_CACHE_LINE_SIZE % 8))
@@ -1476,7 +1852,7 @@ __attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t se
 		ii = HAL_CACHE_LINE_SIZE;
 	}
 
-	size = RING_LEN * sizeof(pfe_hif_bd_t);
+	size = ring->len * sizeof(pfe_hif_bd_t);
 	ring->base_va = oal_mm_malloc_contig_named_aligned_nocache(PFE_CFG_BD_MEM, size, ii);
 
 	if (unlikely(NULL == ring->base_va))
@@ -1502,7 +1878,7 @@ __attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t se
 #endif /* PFE_CFG_HIF_SEQNUM_CHECK */
 
 	/*	Allocate memory for write-back descriptors */
-	size = RING_LEN * sizeof(pfe_hif_wb_bd_t);
+	size = ring->len * sizeof(pfe_hif_wb_bd_t);
 	ring->wb_tbl_base_va = oal_mm_malloc_contig_named_aligned_nocache(PFE_CFG_BD_MEM, size, ii);
 
 	if (unlikely(NULL == ring->wb_tbl_base_va))
@@ -1526,18 +1902,20 @@ __attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t se
 	/*	Initialize state variables */
 	ring->write_idx = 0U;
 	ring->read_idx = 0U;
+	ring->rd_idx_shadow = 0U;
+	ring->wr_idx_shadow = 0U;
 	ring->is_rx = rx;
 	ring->rd_bd = (pfe_hif_bd_t *)ring->base_va;
 	ring->wr_bd = (pfe_hif_bd_t *)ring->base_va;
 
 	/*	Initialize memory */
-	memset(ring->base_va, 0, RING_LEN * sizeof(pfe_hif_bd_t));
+	memset(ring->base_va, 0, ring->len * sizeof(pfe_hif_bd_t));
 
 	/*	Chain the buffer descriptors */
 	hw_desc_va = (pfe_hif_bd_t *)ring->base_va;
 	hw_desc_pa = (pfe_hif_bd_t *)ring->base_pa;
 
-	for (ii=0; ii<RING_LEN; ii++)
+	for (ii=0; ii<ring->len; ii++)
 	{
 		if (TRUE == ring->is_rx)
 		{
@@ -1561,10 +1939,10 @@ __attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t se
 		ring->rd_wb_bd = (pfe_hif_wb_bd_t *)ring->wb_tbl_base_va;
 		ring->wr_wb_bd = (pfe_hif_wb_bd_t *)ring->wb_tbl_base_va;
 
-		memset(ring->wb_tbl_base_va, 0, RING_LEN * sizeof(pfe_hif_wb_bd_t));
+		memset(ring->wb_tbl_base_va, 0, ring->len * sizeof(pfe_hif_wb_bd_t));
 
 		wb_bd_va = (pfe_hif_wb_bd_t *)ring->wb_tbl_base_va;
-		for (ii=0U; ii<RING_LEN; ii++)
+		for (ii=0U; ii<ring->len; ii++)
 		{
 			wb_bd_va->seqnum_buflen_w1 |= HIF_RING_WB_BD_W1_WB_BD_SEQNUM(0xffffU);
 
@@ -1588,7 +1966,7 @@ __attribute__((cold)) static pfe_hif_ring_t *pfe_hif_ring_create_std(uint16_t se
 
 	NXP_LOG_DEBUG("%s ring created. %d entries.\nBD @ p0x%p/v0x%p.\nWB @ p0x%p/v0x%p.\n",
 					variant_str,
-					RING_LEN,
+					ring->len,
 					(void *)ring->base_pa,
 					(void *)ring->base_va,
 					(void *)ring->wb_tbl_base_pa,
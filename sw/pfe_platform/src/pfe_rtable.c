@@ -42,6 +42,14 @@
  */
 #define PFE_RTABLE_CFG_PARANOID_ENTRY_UPDATE	TRUE
 
+/**
+ * @brief	Upper limit of buckets of the duplicate lookup table (power of 2)
+ * @details	The driver keeps own hash index of active entries keyed by the 5-tuple
+ *			to find duplicates without walking the whole list. Number of buckets is
+ *			given by the routing table capacity and limited by this value.
+ */
+#define PFE_RTABLE_CFG_DUP_HTABLE_MAX_SIZE		16384U
+
 /**
  * @brief	Select criterion argument type
  * @details	Used to store and pass argument to the pfe_rtable_match_criterion()
@@ -77,6 +85,8 @@ struct pfe_rtable_tag
 	fifo_t *pool_va;						/*	Pool of entries (virtual addresses) */
 
 	LLIST_t active_entries;					/*	List of active entries. Need to be protected by mutex */
+	LLIST_t *dup_htable;					/*	Buckets of active entries hashed by 5-tuple. Need to be protected by mutex */
+	uint32_t dup_htable_mask;				/*	Number of buckets - 1 */
 
 	oal_mutex_t *lock;						/*	Mutex to protect the table and related resources from concurrent accesses */
 	oal_thread_t *worker;					/*	Worker thread */
@@ -111,6 +121,8 @@ struct pfe_rtable_entry_tag
 	void *callback_arg;							/*	!< User-defined callback argument */
 	LLIST_t list_entry;							/*	!< Linked list element */
 	LLIST_t list_to_remove_entry;				/*	!< Linked list element */
+	LLIST_t list_dup_entry;						/*	!< Duplicate lookup table bucket element */
+	uint32_t dup_hash;							/*	!< 5-tuple hash, see pfe_rtable_entry_is_duplicate() */
 };
 
 /**
@@ -1520,8 +1532,33 @@ static bool_t pfe_rtable_entry_is_in_table(pfe_rtable_entry_t *entry)
 	}
 }
 
+/**
+ * @brief		Compute hash of the 5-tuple for the duplicate lookup table
+ * @details		FNV-1a over the whole structure. The tuple is zeroed before it is
+ * 				filled (see pfe_rtable_entry_to_5t()) so the padding is not an issue.
+ * @param[in]	tuple The 5-tuple
+ * @return		The hash value
+ */
+static uint32_t pfe_rtable_5t_hash(const pfe_5_tuple_t *tuple)
+{
+	const uint8_t *data = (const uint8_t *)tuple;
+	uint32_t hash = 2166136261U;
+	uint32_t ii;
+
+	for (ii=0U; ii<sizeof(pfe_5_tuple_t); ii++)
+	{
+		hash ^= data[ii];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
 /**
  * @brief		Check if entry is already in the table (5-tuple)
+ * @details		Only the bucket of the duplicate lookup table given by the 5-tuple hash
+ * 				is searched. The hash is stored within the entry to be used when the
+ * 				entry is added.
  * @param[in]	rtable The routing table instance
  * @param[in]	entry Entry prototype to be used for search
  * @note		IPv4 addresses within 'entry' are in network order due to way how the type is defined
@@ -1536,6 +1573,7 @@ static bool_t pfe_rtable_entry_is_duplicate(pfe_rtable_t *rtable, pfe_rtable_ent
 	pfe_rtable_criterion_arg_t arg;
 	bool_t match = FALSE;
 	LLIST_t *item;
+	LLIST_t *bucket;
 
 #if defined(PFE_CFG_NULL_ARG_CHECK)
 	if (unlikely((NULL == rtable) || (NULL == entry)))
@@ -1552,16 +1590,19 @@ static bool_t pfe_rtable_entry_is_duplicate(pfe_rtable_t *rtable, pfe_rtable_ent
 		return EINVAL;
 	}
 
+	entry->dup_hash = pfe_rtable_5t_hash(&arg.five_tuple);
+	bucket = &rtable->dup_htable[entry->dup_hash & rtable->dup_htable_mask];
+
 	/*	Search for first matching entry */
-	if (FALSE == LLIST_IsEmpty(&rtable->active_entries))
+	if (FALSE == LLIST_IsEmpty(bucket))
 	{
 		/*	Get first matching entry */
-		LLIST_ForEach(item, &rtable->active_entries)
+		LLIST_ForEach(item, bucket)
 		{
 			/*	Get data */
-			entry2 = LLIST_Data(item, pfe_rtable_entry_t, list_entry);
+			entry2 = LLIST_Data(item, pfe_rtable_entry_t, list_dup_entry);
 
-			if (NULL != entry)
+			if (entry2->dup_hash == entry->dup_hash)
 			{
 				if (TRUE == pfe_rtable_match_criterion(RTABLE_CRIT_BY_5_TUPLE, &arg, entry2))
 				{
@@ -1712,6 +1753,7 @@ errno_t pfe_rtable_add_entry(pfe_rtable_t *rtable, pfe_rtable_entry_t *entry)
 	}
 
 	LLIST_AddAtEnd(&entry->list_entry, &rtable->active_entries);
+	LLIST_AddAtEnd(&entry->list_dup_entry, &rtable->dup_htable[entry->dup_hash & rtable->dup_htable_mask]);
 
 	NXP_LOG_INFO("RTable entry added, hash: 0x%x\n", hash);
 
@@ -1838,6 +1880,7 @@ static errno_t pfe_rtable_del_entry_nolock(pfe_rtable_t *rtable, pfe_rtable_entr
 			}
 
 			LLIST_Remove(&entry->list_entry);
+			LLIST_Remove(&entry->list_dup_entry);
 
 #if (TRUE == PFE_RTABLE_CFG_PARANOID_ENTRY_UPDATE)
 			/*	Validate the new entry */
@@ -1873,6 +1916,7 @@ static errno_t pfe_rtable_del_entry_nolock(pfe_rtable_t *rtable, pfe_rtable_entr
 			}
 
 			LLIST_Remove(&entry->list_entry);
+			LLIST_Remove(&entry->list_dup_entry);
 
 			entry->prev = NULL;
 			entry->next = NULL;
@@ -1920,6 +1964,7 @@ static errno_t pfe_rtable_del_entry_nolock(pfe_rtable_t *rtable, pfe_rtable_entr
 		}
 
 		LLIST_Remove(&entry->list_entry);
+		LLIST_Remove(&entry->list_dup_entry);
 
 		/*	Set up links */
 		entry->prev->next = entry->next;
@@ -2093,6 +2138,7 @@ pfe_rtable_t *pfe_rtable_create(pfe_class_t *class, addr_t htable_base_va, uint3
 	pfe_rtable_t *rtable;
 	pfe_ct_rtable_entry_t *table_va;
 	uint32_t ii;
+	uint32_t dup_htable_size;
 
 #if defined(PFE_CFG_NULL_ARG_CHECK)
 	if (unlikely((NULL_ADDR == htable_base_va) || (NULL_ADDR == pool_base_va) || (NULL == class)))
@@ -2185,6 +2231,28 @@ pfe_rtable_t *pfe_rtable_create(pfe_class_t *class, addr_t htable_base_va, uint3
 		/*	Create list */
 		LLIST_Init(&rtable->active_entries);
 
+		/*	Create duplicate lookup table, a bucket per entry the table can hold */
+		dup_htable_size = 1U;
+		while ((dup_htable_size < (rtable->htable_size + rtable->pool_size))
+				&& (dup_htable_size < PFE_RTABLE_CFG_DUP_HTABLE_MAX_SIZE))
+		{
+			dup_htable_size <<= 1;
+		}
+
+		rtable->dup_htable = oal_mm_malloc(dup_htable_size * sizeof(LLIST_t));
+		if (NULL == rtable->dup_htable)
+		{
+			NXP_LOG_ERROR("Can't create duplicate lookup table\n");
+			goto free_and_fail;
+		}
+
+		for (ii=0U; ii<dup_htable_size; ii++)
+		{
+			LLIST_Init(&rtable->dup_htable[ii]);
+		}
+
+		rtable->dup_htable_mask = dup_htable_size - 1U;
+
 		/*	Create mbox */
 		rtable->mbox = oal_mbox_create();
 		if (NULL == rtable->mbox)
@@ -2297,6 +2365,12 @@ void pfe_rtable_destroy(pfe_rtable_t *rtable)
 			rtable->pool_va = NULL;
 		}
 
+		if (NULL != rtable->dup_htable)
+		{
+			oal_mm_free(rtable->dup_htable);
+			rtable->dup_htable = NULL;
+		}
+
 		if (NULL != rtable->lock)
 		{
 			oal_mutex_destroy(rtable->lock);